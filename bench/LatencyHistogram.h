@@ -0,0 +1,127 @@
+#pragma once
+
+#include "LevelBitmap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace orderbook
+{
+
+    /**
+     * HDR-style log-linear latency histogram.
+     * Values below 2^precisionBits are counted exactly; above that every power
+     * of two is split into 2^precisionBits linear sub-buckets, so any recorded
+     * value is reported within 1 / 2^precisionBits relative error (0.8% by
+     * default) across the full 64-bit range with a fixed memory footprint.
+     */
+    class LatencyHistogram
+    {
+    public:
+        explicit LatencyHistogram(unsigned precisionBits = 7)
+            : bits_(precisionBits),
+              subBuckets_(std::uint64_t{1} << precisionBits),
+              counts_(subBuckets_ * (65 - precisionBits), 0)
+        {
+        }
+
+        void record(std::uint64_t value)
+        {
+            ++counts_[indexOf(value)];
+            ++count_;
+            sum_ += static_cast<double>(value);
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+
+        void merge(const LatencyHistogram &other)
+        {
+            for (std::size_t i = 0; i < counts_.size() && i < other.counts_.size(); ++i)
+            {
+                counts_[i] += other.counts_[i];
+            }
+            count_ += other.count_;
+            sum_ += other.sum_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        void reset()
+        {
+            std::fill(counts_.begin(), counts_.end(), 0);
+            count_ = 0;
+            sum_ = 0.0;
+            min_ = std::numeric_limits<std::uint64_t>::max();
+            max_ = 0;
+        }
+
+        /**
+         * Value at or below which `percent` of recorded values fall
+         * @param percent Percentile in [0, 100]
+         * @return Highest value equivalent to the bucket holding that rank
+         */
+        std::uint64_t percentile(double percent) const
+        {
+            if (count_ == 0)
+            {
+                return 0;
+            }
+
+            std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(count_)));
+            rank = std::max<std::uint64_t>(rank, 1);
+
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < counts_.size(); ++i)
+            {
+                seen += counts_[i];
+                if (seen >= rank)
+                {
+                    return std::min(highestEquivalent(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        std::uint64_t count() const { return count_; }
+        std::uint64_t min() const { return count_ ? min_ : 0; }
+        std::uint64_t max() const { return max_; }
+        double mean() const { return count_ ? sum_ / static_cast<double>(count_) : 0.0; }
+
+    private:
+        std::size_t indexOf(std::uint64_t value) const
+        {
+            if (value < subBuckets_)
+            {
+                return static_cast<std::size_t>(value);
+            }
+
+            unsigned msb = detail::highestBit(value);
+            unsigned exponent = msb - bits_;
+            std::uint64_t mantissa = value >> exponent; // In [subBuckets_, 2 * subBuckets_)
+            return static_cast<std::size_t>(subBuckets_ * (exponent + 1) + (mantissa - subBuckets_));
+        }
+
+        std::uint64_t highestEquivalent(std::size_t index) const
+        {
+            if (index < subBuckets_)
+            {
+                return index;
+            }
+
+            std::uint64_t exponent = index / subBuckets_ - 1;
+            std::uint64_t mantissa = subBuckets_ + index % subBuckets_;
+            return ((mantissa + 1) << exponent) - 1;
+        }
+
+        unsigned bits_;
+        std::uint64_t subBuckets_;
+        std::vector<std::uint64_t> counts_;
+        std::uint64_t count_ = 0;
+        double sum_ = 0.0;
+        std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t max_ = 0;
+    };
+
+} // namespace orderbook
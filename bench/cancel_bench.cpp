@@ -0,0 +1,132 @@
+#include "OrderBook.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace orderbook;
+
+/**
+ * Measures cancel latency against queue depth at a single price level.
+ * The level is held at a constant depth by re-adding one order for every
+ * cancel, and cancels target uniformly random queue positions, so an O(n)
+ * level container shows up as latency growing with depth.
+ */
+double measureCancelNanos(std::size_t depth, std::size_t samples, std::mt19937_64 &rng)
+{
+    OrderBook book;
+    std::vector<std::uint64_t> live;
+    live.reserve(depth);
+
+    std::uint64_t nextId = 1;
+    for (std::size_t i = 0; i < depth; ++i)
+    {
+        book.addOrder(std::make_shared<Order>(nextId, OrderSide::BUY, 100.00, 10));
+        live.push_back(nextId++);
+    }
+
+    std::chrono::nanoseconds total{0};
+    for (std::size_t i = 0; i < samples; ++i)
+    {
+        std::size_t pick = std::uniform_int_distribution<std::size_t>(0, live.size() - 1)(rng);
+        std::uint64_t victim = live[pick];
+        live[pick] = live.back();
+        live.pop_back();
+
+        auto start = std::chrono::steady_clock::now();
+        book.cancelOrder(victim);
+        total += std::chrono::steady_clock::now() - start;
+
+        book.addOrder(std::make_shared<Order>(nextId, OrderSide::BUY, 100.00, 10));
+        live.push_back(nextId++);
+    }
+
+    return static_cast<double>(total.count()) / static_cast<double>(samples);
+}
+
+/**
+ * Measures the cost of building a single price level of `depth` orders.
+ * Appending to a level's FIFO is O(1), so the time per insert should stay
+ * flat as the level deepens; a per-insert sort would grow it with depth.
+ */
+double measureInsertNanos(std::size_t depth)
+{
+    std::vector<std::shared_ptr<Order>> orders;
+    orders.reserve(depth);
+    for (std::uint64_t id = 1; id <= depth; ++id)
+    {
+        orders.push_back(std::make_shared<Order>(id, OrderSide::SELL, 100.00, 1));
+    }
+
+    OrderBook book;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &order : orders)
+    {
+        book.addOrder(order);
+    }
+    std::chrono::nanoseconds total = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(total.count()) / static_cast<double>(depth);
+}
+
+void printUsage()
+{
+    std::cerr << "Usage: orderbook_cancel_bench [cancels_per_depth]" << std::endl;
+}
+
+// Parses a positive decimal count; rejects signs, trailing garbage and zero
+bool parseCount(const char *text, std::size_t &out)
+{
+    if (text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    char *end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end != '\0' || value == 0)
+    {
+        return false;
+    }
+    out = static_cast<std::size_t>(value);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t samples = 20000;
+    if (argc > 2 || (argc > 1 && !parseCount(argv[1], samples)))
+    {
+        printUsage();
+        return 1;
+    }
+    const std::size_t depths[] = {10, 100, 1000, 10000, 100000};
+
+    std::mt19937_64 rng(42);
+
+    std::cout << "Cancel latency vs queue depth (" << samples << " cancels per depth)" << std::endl;
+    std::cout << std::setw(10) << "depth" << std::setw(16) << "ns/cancel" << std::endl;
+
+    for (std::size_t depth : depths)
+    {
+        double nanos = measureCancelNanos(depth, samples, rng);
+        std::cout << std::setw(10) << depth << std::setw(16) << std::fixed << std::setprecision(1) << nanos << std::endl;
+    }
+
+    std::cout << std::endl
+              << "Insert cost vs level depth (one level filled from empty)" << std::endl;
+    std::cout << std::setw(10) << "depth" << std::setw(16) << "ns/insert" << std::endl;
+
+    double insertNanos[sizeof(depths) / sizeof(depths[0])];
+    for (std::size_t i = 0; i < sizeof(depths) / sizeof(depths[0]); ++i)
+    {
+        insertNanos[i] = measureInsertNanos(depths[i]);
+        std::cout << std::setw(10) << depths[i] << std::setw(16) << std::fixed << std::setprecision(1) << insertNanos[i]
+                  << std::endl;
+    }
+    // Per-insert cost at 100000 relative to 10000; near 1 for O(1) appends, ~10 for a per-insert sort
+    std::cout << "Per-insert ratio 100000/10000: " << std::setprecision(2) << insertNanos[4] / insertNanos[3]
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include "EngineThread.h"
+#include "LatencyHistogram.h"
+#include "MpscRing.h"
+#include "OrderBook.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace orderbook;
+
+/**
+ * Enqueue-to-ack round-trip latency through the engine thread.
+ * A client thread pinned to one core submits a single command, spins until
+ * its ack comes back from the engine thread pinned to another core, and
+ * records the round trip. Commands alternate between a passive add and the
+ * cancel of that add, so the book stays small and the figure is dominated
+ * by the two ring hand-offs and the cross-core cache-line transfers.
+ *
+ * Usage: orderbook_engine_ring_bench [--samples N] [--wait spin|yield|block]
+ *                                    [--client-cpu N|-1] [--engine-cpu N|-1] [--mpsc]
+ */
+
+namespace
+{
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Config
+    {
+        std::size_t samples = 200000;
+        WaitStrategy wait = WaitStrategy::BusySpin;
+        int clientCpu = 0;
+        int engineCpu = 1;
+        bool mpsc = false;
+    };
+
+    void printUsage()
+    {
+        std::cerr << "Usage: orderbook_engine_ring_bench [--samples N] [--wait spin|yield|block]\n"
+                     "                                   [--client-cpu N|-1] [--engine-cpu N|-1] [--mpsc]"
+                  << std::endl;
+    }
+
+    // Parses a positive decimal count; rejects signs, trailing garbage and zero
+    bool parseCount(const char *text, std::size_t &out)
+    {
+        if (text[0] < '0' || text[0] > '9')
+        {
+            return false;
+        }
+        char *end = nullptr;
+        const unsigned long long value = std::strtoull(text, &end, 10);
+        if (*end != '\0' || value == 0)
+        {
+            return false;
+        }
+        out = static_cast<std::size_t>(value);
+        return true;
+    }
+
+    // Parses a CPU index, or -1 to leave the thread unpinned
+    bool parseCpu(const char *text, int &out)
+    {
+        if (std::strcmp(text, "-1") == 0)
+        {
+            out = -1;
+            return true;
+        }
+        if (text[0] < '0' || text[0] > '9')
+        {
+            return false;
+        }
+        char *end = nullptr;
+        const unsigned long long value = std::strtoull(text, &end, 10);
+        if (*end != '\0' || value > static_cast<unsigned long long>(std::numeric_limits<int>::max()))
+        {
+            return false;
+        }
+        out = static_cast<int>(value);
+        return true;
+    }
+
+    bool parseArgs(int argc, char **argv, Config &config)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (arg == "--mpsc")
+            {
+                config.mpsc = true;
+                continue;
+            }
+            if (!value)
+            {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            ++i;
+
+            if (arg == "--samples")
+            {
+                if (!parseCount(value, config.samples))
+                {
+                    std::cerr << "--samples expects a positive count" << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--wait")
+            {
+                if (std::strcmp(value, "spin") == 0)
+                {
+                    config.wait = WaitStrategy::BusySpin;
+                }
+                else if (std::strcmp(value, "yield") == 0)
+                {
+                    config.wait = WaitStrategy::Yield;
+                }
+                else if (std::strcmp(value, "block") == 0)
+                {
+                    config.wait = WaitStrategy::Block;
+                }
+                else
+                {
+                    std::cerr << "--wait expects spin, yield or block" << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--client-cpu")
+            {
+                if (!parseCpu(value, config.clientCpu))
+                {
+                    std::cerr << "--client-cpu expects a CPU index or -1 for unpinned" << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--engine-cpu")
+            {
+                if (!parseCpu(value, config.engineCpu))
+                {
+                    std::cerr << "--engine-cpu expects a CPU index or -1 for unpinned" << std::endl;
+                    return false;
+                }
+            }
+            else
+            {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Ingress>
+    LatencyHistogram run(const Config &config)
+    {
+        OrderBook book;
+        EngineThreadOptions options;
+        options.wait = config.wait;
+        options.cpu = config.engineCpu;
+        EngineThread<OrderBook, Ingress> engine(book, options);
+        engine.start();
+
+        pinCurrentThread(config.clientCpu);
+
+        LatencyHistogram histogram;
+        EngineCommand command;
+        EngineAck ack;
+        const std::size_t warmup = config.samples / 10;
+        for (std::size_t i = 0; i < warmup + config.samples; ++i)
+        {
+            const std::uint64_t id = i / 2 + 1;
+            command.clientTag = i;
+            command.request.type = (i & 1) ? RequestType::Cancel : RequestType::Add;
+            command.request.side = OrderSide::BUY;
+            command.request.orderId = id;
+            command.request.price = 100.00;
+            command.request.quantity = 10;
+
+            const Clock::time_point start = Clock::now();
+            engine.submit(command);
+            while (!engine.pollAck(ack))
+            {
+                cpuRelax();
+            }
+            const Clock::time_point end = Clock::now();
+
+            if (i >= warmup)
+            {
+                histogram.record(static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+            }
+        }
+
+        engine.stop();
+        return histogram;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Config config;
+    if (!parseArgs(argc, argv, config))
+    {
+        printUsage();
+        return 1;
+    }
+
+    LatencyHistogram histogram = config.mpsc ? run<MpscRing<EngineCommand>>(config)
+                                             : run<SpscRing<EngineCommand>>(config);
+
+    const char *waitName = config.wait == WaitStrategy::Block   ? "block"
+                           : config.wait == WaitStrategy::Yield ? "yield"
+                                                                : "spin";
+    std::cout << "Engine ring round trip: " << config.samples << " samples, "
+              << (config.mpsc ? "MPSC" : "SPSC") << " ingress, wait " << waitName << ", client cpu "
+              << config.clientCpu << ", engine cpu " << config.engineCpu << std::endl;
+    std::cout << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99"
+              << std::setw(10) << "p99.9" << std::setw(12) << "max" << "  (ns)" << std::endl;
+    std::cout << std::fixed << std::setprecision(1) << std::setw(10) << histogram.mean() << std::setw(10)
+              << histogram.percentile(50.0) << std::setw(10) << histogram.percentile(99.0) << std::setw(10)
+              << histogram.percentile(99.9) << std::setw(12) << histogram.max() << std::endl;
+    return 0;
+}
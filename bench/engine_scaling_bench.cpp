@@ -0,0 +1,132 @@
+#include "MatchingEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace orderbook;
+
+/**
+ * Aggregate throughput of the sharded matching engine as shards are added.
+ * Thousands of symbols are spread round-robin over the shards; one producer
+ * thread per shard submits a mix of passive adds, crossing adds and cancels
+ * for the symbols of that shard, with acks disabled. Throughput is measured
+ * from processedCommands(), so it counts only commands actually applied.
+ *
+ * Usage: orderbook_engine_scaling_bench [commands_per_shard] [symbols] [max_shards]
+ */
+
+namespace
+{
+
+    using Clock = std::chrono::steady_clock;
+
+    double runEngine(std::size_t shards, std::size_t symbols, std::size_t commandsPerShard)
+    {
+        MatchingEngineOptions options;
+        options.shards = shards;
+        options.acks = false;
+        options.wait = WaitStrategy::Yield;
+        for (std::size_t i = 0; i < shards; ++i)
+        {
+            options.cpus.push_back(static_cast<int>(i));
+        }
+        MatchingEngine engine(options);
+
+        BookOptions bookOptions;
+        bookOptions.expectedOrders = 256;
+        for (std::size_t s = 0; s < symbols; ++s)
+        {
+            engine.addSymbol("S" + std::to_string(s), bookOptions);
+        }
+        engine.start();
+
+        const Clock::time_point start = Clock::now();
+        std::vector<std::thread> producers;
+        for (std::size_t p = 0; p < shards; ++p)
+        {
+            producers.emplace_back([&, p]
+                                   {
+                                       std::mt19937_64 rng(p + 1);
+                                       const std::size_t owned = (symbols - p + shards - 1) / shards;
+                                       EngineCommand command;
+                                       for (std::size_t i = 0; i < commandsPerShard; ++i)
+                                       {
+                                           const SymbolId symbol = static_cast<SymbolId>(p + (rng() % owned) * shards);
+                                           const std::uint64_t roll = rng();
+                                           command.request.type = roll % 4 == 0 ? RequestType::Cancel : RequestType::Add;
+                                           command.request.orderId = 1 + (roll >> 8) % 128;
+                                           command.request.side = (roll >> 16) & 1 ? OrderSide::BUY : OrderSide::SELL;
+                                           command.request.price = 99.90 + 0.01 * ((roll >> 24) % 20);
+                                           command.request.quantity = 1 + (roll >> 32) % 100;
+                                           engine.submit(symbol, command);
+                                       } });
+        }
+        for (std::thread &producer : producers)
+        {
+            producer.join();
+        }
+        engine.stop();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return static_cast<double>(engine.processedCommands()) / seconds;
+    }
+
+    void printUsage()
+    {
+        std::cerr << "Usage: orderbook_engine_scaling_bench [commands_per_shard] [symbols] [max_shards]" << std::endl;
+    }
+
+    // Parses a positive decimal count; rejects signs, trailing garbage and zero
+    bool parseCount(const char *text, std::size_t &out)
+    {
+        if (text[0] < '0' || text[0] > '9')
+        {
+            return false;
+        }
+        char *end = nullptr;
+        const unsigned long long value = std::strtoull(text, &end, 10);
+        if (*end != '\0' || value == 0)
+        {
+            return false;
+        }
+        out = static_cast<std::size_t>(value);
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::size_t commandsPerShard = 1000000;
+    std::size_t symbols = 8000;
+    std::size_t maxShards = std::max(1u, std::thread::hardware_concurrency() / 2);
+    if (argc > 4 || (argc > 1 && !parseCount(argv[1], commandsPerShard)) ||
+        (argc > 2 && !parseCount(argv[2], symbols)) || (argc > 3 && !parseCount(argv[3], maxShards)))
+    {
+        printUsage();
+        return 1;
+    }
+    // Every shard needs at least one symbol for its producer to target
+    maxShards = std::min(maxShards, symbols);
+
+    std::cout << "Matching engine scaling: " << symbols << " symbols, " << commandsPerShard
+              << " commands per shard, one producer per shard" << std::endl;
+    std::cout << std::setw(8) << "shards" << std::setw(16) << "Mcmd/s" << std::setw(12) << "speedup" << std::endl;
+
+    double baseline = 0.0;
+    for (std::size_t shards = 1; shards <= maxShards; shards *= 2)
+    {
+        const double rate = runEngine(shards, symbols, commandsPerShard);
+        if (shards == 1)
+        {
+            baseline = rate;
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << shards << std::setw(16) << rate / 1e6
+                  << std::setw(12) << rate / baseline << std::endl;
+    }
+    return 0;
+}
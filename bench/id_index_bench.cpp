@@ -0,0 +1,153 @@
+#include "OrderIdIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace orderbook;
+
+/**
+ * Compares OrderIdIndex against the previous std::map<uint64_t, Order *>
+ * id lookup at large resting-order counts. Each phase runs the book's access
+ * pattern: inserts of sequential ids, random lookups of resting ids, then
+ * random erases (cancels and fills).
+ */
+struct PhaseTimes
+{
+    double insertNs;
+    double findNs;
+    double eraseNs;
+};
+
+template <typename Insert, typename Find, typename Erase>
+PhaseTimes runPhases(std::size_t count, const std::vector<std::uint64_t> &probes, Insert insert, Find find, Erase erase)
+{
+    using Clock = std::chrono::steady_clock;
+    PhaseTimes times{};
+    Order order(0, OrderSide::BUY, 0.0, 1);
+    Order *dummy = &order;
+
+    auto start = Clock::now();
+    for (std::uint64_t id = 1; id <= count; ++id)
+    {
+        insert(id, dummy);
+    }
+    times.insertNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+    std::size_t hits = 0;
+    start = Clock::now();
+    for (std::uint64_t id : probes)
+    {
+        hits += find(id) != nullptr;
+    }
+    times.findNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / probes.size();
+
+    start = Clock::now();
+    for (std::uint64_t id : probes)
+    {
+        erase(id);
+    }
+    times.eraseNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / probes.size();
+
+    if (hits != probes.size())
+    {
+        std::cerr << "lookup mismatch" << std::endl;
+    }
+    return times;
+}
+
+void printRow(const char *name, std::size_t count, const PhaseTimes &times)
+{
+    std::cout << std::setw(14) << name << std::setw(12) << count << std::fixed << std::setprecision(1)
+              << std::setw(12) << times.insertNs << std::setw(12) << times.findNs << std::setw(12) << times.eraseNs
+              << std::endl;
+}
+
+void printUsage()
+{
+    std::cerr << "Usage: orderbook_id_index_bench [orders...]   (each at least 2)" << std::endl;
+}
+
+// Parses a positive decimal count; rejects signs, trailing garbage and zero
+bool parseCount(const char *text, std::size_t &out)
+{
+    if (text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    char *end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end != '\0' || value == 0)
+    {
+        return false;
+    }
+    out = static_cast<std::size_t>(value);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::size_t> counts;
+    for (int i = 1; i < argc; ++i)
+    {
+        // Half of the ids are probed, so a single order would leave nothing to time
+        std::size_t count = 0;
+        if (!parseCount(argv[i], count) || count < 2)
+        {
+            printUsage();
+            return 1;
+        }
+        counts.push_back(count);
+    }
+    if (counts.empty())
+    {
+        counts = {1000000, 10000000};
+    }
+
+    std::cout << std::setw(14) << "index" << std::setw(12) << "orders" << std::setw(12) << "insert ns"
+              << std::setw(12) << "find ns" << std::setw(12) << "erase ns" << std::endl;
+
+    for (std::size_t count : counts)
+    {
+        // Distinct random resting ids, so erase never misses
+        std::vector<std::uint64_t> probes(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            probes[i] = i + 1;
+        }
+        std::shuffle(probes.begin(), probes.end(), std::mt19937_64(11));
+        probes.resize(count / 2);
+
+        {
+            std::map<std::uint64_t, Order *> map;
+            printRow("std::map", count,
+                     runPhases(
+                         count, probes,
+                         [&](std::uint64_t id, Order *order)
+                         { map.emplace(id, order); },
+                         [&](std::uint64_t id)
+                         { auto it = map.find(id); return it == map.end() ? nullptr : it->second; },
+                         [&](std::uint64_t id)
+                         { map.erase(id); }));
+        }
+
+        {
+            OrderIdIndex index(count);
+            printRow("OrderIdIndex", count,
+                     runPhases(
+                         count, probes,
+                         [&](std::uint64_t id, Order *order)
+                         { index.insert(id, order); },
+                         [&](std::uint64_t id)
+                         { return index.find(id); },
+                         [&](std::uint64_t id)
+                         { index.erase(id); }));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "OrderBook.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace orderbook;
+
+/**
+ * Compares the Map and Ladder price level backends on an add/cancel/match mix.
+ * Passive orders are placed within `band` ticks behind the touch, a fraction
+ * of adds cross the spread, and cancels hit random resting orders. Both
+ * backends replay the identical operation stream.
+ */
+struct Mix
+{
+    const char *name;
+    int addPercent;    // Passive adds
+    int cancelPercent; // Cancels of random resting orders
+    // Remainder: aggressive adds that cross the spread
+};
+
+double runMix(LevelStorage storage, const Mix &mix, std::size_t operations, int band)
+{
+    BookOptions options;
+    options.levelStorage = storage;
+    OrderBook book(options);
+
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<int> offset(1, band);
+    std::uniform_int_distribution<int> quantity(1, 100);
+
+    const Price mid = 10000;
+    std::vector<std::uint64_t> live;
+    std::uint64_t nextId = 1;
+
+    // Seed both sides so cancels and matches have something to hit
+    for (int i = 0; i < band * 4; ++i)
+    {
+        OrderSide side = (i & 1) ? OrderSide::BUY : OrderSide::SELL;
+        Price ticks = side == OrderSide::BUY ? mid - offset(rng) : mid + offset(rng);
+        book.addOrder(Order(nextId, side, book.toPrice(ticks), quantity(rng)));
+        live.push_back(nextId++);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t op = 0; op < operations; ++op)
+    {
+        int roll = percent(rng);
+        OrderSide side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+
+        if (roll < mix.addPercent)
+        {
+            Price ticks = side == OrderSide::BUY ? mid - offset(rng) : mid + offset(rng);
+            book.addOrder(Order(nextId, side, book.toPrice(ticks), quantity(rng)));
+            live.push_back(nextId++);
+        }
+        else if (roll < mix.addPercent + mix.cancelPercent && !live.empty())
+        {
+            std::size_t pick = std::uniform_int_distribution<std::size_t>(0, live.size() - 1)(rng);
+            book.cancelOrder(live[pick]);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+        else
+        {
+            // Cross a few ticks into the opposite side
+            Price ticks = side == OrderSide::BUY ? mid + offset(rng) / 4 : mid - offset(rng) / 4;
+            book.addOrder(Order(nextId, side, book.toPrice(ticks), quantity(rng)));
+            live.push_back(nextId++);
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return static_cast<double>(operations) / elapsed;
+}
+
+void printUsage()
+{
+    std::cerr << "Usage: orderbook_ladder_bench [operations] [band_ticks]" << std::endl;
+}
+
+// Parses a positive decimal count; rejects signs, trailing garbage and zero
+bool parseCount(const char *text, std::size_t &out)
+{
+    if (text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    char *end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end != '\0' || value == 0)
+    {
+        return false;
+    }
+    out = static_cast<std::size_t>(value);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t operations = 1000000;
+    std::size_t bandTicks = 200;
+    if (argc > 3 || (argc > 1 && !parseCount(argv[1], operations)) ||
+        (argc > 2 && (!parseCount(argv[2], bandTicks) ||
+                      bandTicks > static_cast<std::size_t>(std::numeric_limits<int>::max()))))
+    {
+        printUsage();
+        return 1;
+    }
+    const int band = static_cast<int>(bandTicks);
+
+    const Mix mixes[] = {
+        {"add-heavy", 60, 30},
+        {"cancel-heavy", 45, 50},
+        {"match-heavy", 40, 20},
+    };
+
+    std::cout << "Price level backend comparison (" << operations << " ops, band " << band << " ticks)" << std::endl;
+    std::cout << std::setw(14) << "mix" << std::setw(16) << "map ops/s" << std::setw(16) << "ladder ops/s"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (const Mix &mix : mixes)
+    {
+        double mapRate = runMix(LevelStorage::Map, mix, operations, band);
+        double ladderRate = runMix(LevelStorage::Ladder, mix, operations, band);
+
+        std::cout << std::setw(14) << mix.name << std::fixed << std::setprecision(0)
+                  << std::setw(16) << mapRate << std::setw(16) << ladderRate
+                  << std::setprecision(2) << std::setw(9) << ladderRate / mapRate << "x" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,430 @@
+#include "LatencyHistogram.h"
+#include "OrderBook.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace orderbook;
+
+/**
+ * End-to-end engine benchmark.
+ * Builds a resting book of the requested depth, then drives a random mix of
+ * passive adds, cancels, modifies and aggressive (crossing) adds against it,
+ * timing every call individually. Reports overall throughput and a latency
+ * histogram per operation type, as a table or as JSON for regression
+ * tracking between releases. Throughput is operations divided by the time
+ * spent inside engine calls, so driver overhead is excluded.
+ *
+ * Usage: orderbook_bench [--ops N] [--depth N] [--band TICKS]
+ *                        [--mix ADD,CANCEL,MODIFY,MATCH] [--backend map|ladder]
+ *                        [--seed N] [--json]
+ */
+
+namespace
+{
+
+    enum Operation
+    {
+        kAdd,
+        kCancel,
+        kModify,
+        kMatch,
+        kOperationCount
+    };
+
+    const char *const kOperationNames[kOperationCount] = {"add", "cancel", "modify", "match"};
+
+    struct Config
+    {
+        std::size_t operations = 1000000;
+        std::size_t depth = 10000;
+        int band = 100;
+        int mix[kOperationCount] = {45, 35, 10, 10};
+        LevelStorage backend = LevelStorage::Map;
+        std::uint64_t seed = 1;
+        bool json = false;
+        bool help = false;
+    };
+
+    // Tracks remaining quantity per id so the driver only cancels/modifies live orders
+    struct BenchListener : BookListener
+    {
+        std::vector<std::uint64_t> *remaining = nullptr;
+
+        void onTrade(const Trade &trade)
+        {
+            (*remaining)[trade.buyOrderId] -= trade.quantity;
+            (*remaining)[trade.sellOrderId] -= trade.quantity;
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    void printUsage()
+    {
+        std::cerr << "Usage: orderbook_bench [--ops N] [--depth N] [--band TICKS]\n"
+                     "                       [--mix ADD,CANCEL,MODIFY,MATCH] [--backend map|ladder]\n"
+                     "                       [--seed N] [--json] [--help]"
+                  << std::endl;
+    }
+
+    // Parses an unsigned decimal value; rejects signs, trailing garbage and empty input
+    bool parseUnsigned(const char *text, std::uint64_t &out)
+    {
+        if (text[0] < '0' || text[0] > '9')
+        {
+            return false;
+        }
+        char *end = nullptr;
+        out = std::strtoull(text, &end, 10);
+        return *end == '\0';
+    }
+
+    bool parseArgs(int argc, char **argv, Config &config)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (arg == "--help" || arg == "-h")
+            {
+                config.help = true;
+                return true;
+            }
+            if (arg == "--json")
+            {
+                config.json = true;
+                continue;
+            }
+            if (!value)
+            {
+                std::cerr << "Missing value for " << arg << std::endl;
+                return false;
+            }
+            ++i;
+
+            if (arg == "--ops")
+            {
+                std::uint64_t operations = 0;
+                if (!parseUnsigned(value, operations) || operations == 0)
+                {
+                    std::cerr << "--ops expects a positive count" << std::endl;
+                    return false;
+                }
+                config.operations = operations;
+            }
+            else if (arg == "--depth")
+            {
+                std::uint64_t depth = 0;
+                if (!parseUnsigned(value, depth))
+                {
+                    std::cerr << "--depth expects a non-negative count" << std::endl;
+                    return false;
+                }
+                config.depth = depth;
+            }
+            else if (arg == "--band")
+            {
+                std::uint64_t band = 0;
+                if (!parseUnsigned(value, band) || band == 0 ||
+                    band > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+                {
+                    std::cerr << "--band expects a positive tick count" << std::endl;
+                    return false;
+                }
+                config.band = static_cast<int>(band);
+            }
+            else if (arg == "--seed")
+            {
+                if (!parseUnsigned(value, config.seed))
+                {
+                    std::cerr << "--seed expects a non-negative integer" << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--backend")
+            {
+                if (std::strcmp(value, "map") == 0)
+                {
+                    config.backend = LevelStorage::Map;
+                }
+                else if (std::strcmp(value, "ladder") == 0)
+                {
+                    config.backend = LevelStorage::Ladder;
+                }
+                else
+                {
+                    std::cerr << "--backend expects map or ladder" << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--mix")
+            {
+                int parsed = std::sscanf(value, "%d,%d,%d,%d", &config.mix[kAdd], &config.mix[kCancel],
+                                         &config.mix[kModify], &config.mix[kMatch]);
+                if (parsed != kOperationCount)
+                {
+                    std::cerr << "--mix expects ADD,CANCEL,MODIFY,MATCH weights" << std::endl;
+                    return false;
+                }
+                std::uint64_t total = 0;
+                for (int weight : config.mix)
+                {
+                    if (weight < 0)
+                    {
+                        std::cerr << "--mix weights must not be negative" << std::endl;
+                        return false;
+                    }
+                    total += static_cast<std::uint64_t>(weight);
+                }
+                if (total == 0)
+                {
+                    std::cerr << "--mix weights must not all be zero" << std::endl;
+                    return false;
+                }
+            }
+            else
+            {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void printText(const Config &config, double seconds, const LatencyHistogram (&histograms)[kOperationCount],
+                   const LatencyHistogram &all)
+    {
+        std::cout << "OrderBook benchmark: " << config.operations << " ops, depth " << config.depth
+                  << ", band " << config.band << " ticks, backend "
+                  << (config.backend == LevelStorage::Ladder ? "ladder" : "map") << std::endl;
+        std::cout << "Throughput: " << std::fixed << std::setprecision(0)
+                  << static_cast<double>(config.operations) / seconds << " ops/s" << std::endl
+                  << std::endl;
+
+        std::cout << std::setw(8) << "op" << std::setw(12) << "count" << std::setw(10) << "mean"
+                  << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+                  << std::setw(12) << "max" << "  (ns)" << std::endl;
+
+        auto row = [](const char *name, const LatencyHistogram &h)
+        {
+            std::cout << std::setw(8) << name << std::setw(12) << h.count() << std::setw(10)
+                      << std::setprecision(1) << h.mean() << std::setw(10) << h.percentile(50.0)
+                      << std::setw(10) << h.percentile(99.0) << std::setw(10) << h.percentile(99.9)
+                      << std::setw(12) << h.max() << std::endl;
+        };
+        for (int op = 0; op < kOperationCount; ++op)
+        {
+            row(kOperationNames[op], histograms[op]);
+        }
+        row("all", all);
+    }
+
+    void printJson(const Config &config, double seconds, const LatencyHistogram (&histograms)[kOperationCount],
+                   const LatencyHistogram &all)
+    {
+        auto stats = [](const LatencyHistogram &h)
+        {
+            std::cout << "{\"count\":" << h.count() << ",\"mean_ns\":" << std::fixed << std::setprecision(1)
+                      << h.mean() << ",\"p50_ns\":" << h.percentile(50.0) << ",\"p99_ns\":" << h.percentile(99.0)
+                      << ",\"p999_ns\":" << h.percentile(99.9) << ",\"max_ns\":" << h.max() << "}";
+        };
+
+        std::cout << "{\"config\":{\"ops\":" << config.operations << ",\"depth\":" << config.depth
+                  << ",\"band\":" << config.band << ",\"backend\":\""
+                  << (config.backend == LevelStorage::Ladder ? "ladder" : "map") << "\",\"seed\":" << config.seed
+                  << ",\"mix\":[" << config.mix[kAdd] << "," << config.mix[kCancel] << "," << config.mix[kModify]
+                  << "," << config.mix[kMatch] << "]},";
+        std::cout << "\"throughput_ops_per_sec\":" << std::fixed << std::setprecision(0)
+                  << static_cast<double>(config.operations) / seconds << ",\"latency\":{";
+        for (int op = 0; op < kOperationCount; ++op)
+        {
+            std::cout << "\"" << kOperationNames[op] << "\":";
+            stats(histograms[op]);
+            std::cout << ",";
+        }
+        std::cout << "\"all\":";
+        stats(all);
+        std::cout << "}}" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Config config;
+    if (!parseArgs(argc, argv, config))
+    {
+        printUsage();
+        return 1;
+    }
+    if (config.help)
+    {
+        printUsage();
+        return 0;
+    }
+
+    std::uint64_t totalWeight = 0;
+    for (int weight : config.mix)
+    {
+        totalWeight += static_cast<std::uint64_t>(weight);
+    }
+
+    std::vector<std::uint64_t> remaining(config.depth + config.operations + 1, 0);
+    std::vector<OrderSide> sides(remaining.size(), OrderSide::BUY);
+
+    BookOptions options;
+    options.levelStorage = config.backend;
+    options.expectedOrders = config.depth * 2;
+    BenchListener listener;
+    listener.remaining = &remaining;
+    BasicOrderBook<BenchListener> book(options, listener);
+
+    std::mt19937_64 rng(config.seed);
+    std::uniform_int_distribution<int> offset(1, config.band);
+    std::uniform_int_distribution<std::uint64_t> quantity(1, 100);
+    std::uniform_int_distribution<std::uint64_t> roll(0, totalWeight - 1);
+
+    const Price mid = 100000;
+    std::vector<std::uint64_t> live;
+    live.reserve(config.depth * 2);
+    std::uint64_t nextId = 1;
+
+    auto passivePrice = [&](OrderSide side)
+    {
+        return book.toPrice(side == OrderSide::BUY ? mid - offset(rng) : mid + offset(rng));
+    };
+
+    // Resting book: non-crossing orders on both sides
+    for (std::size_t i = 0; i < config.depth; ++i)
+    {
+        OrderSide side = (i & 1) ? OrderSide::BUY : OrderSide::SELL;
+        remaining[nextId] = quantity(rng);
+        sides[nextId] = side;
+        book.addOrder(nextId, side, passivePrice(side), remaining[nextId]);
+        live.push_back(nextId++);
+    }
+
+    // Pick a random live order, dropping filled ones (untimed)
+    auto pickLive = [&]() -> std::size_t
+    {
+        while (!live.empty())
+        {
+            std::size_t pick = std::uniform_int_distribution<std::size_t>(0, live.size() - 1)(rng);
+            if (remaining[live[pick]] > 0)
+            {
+                return pick;
+            }
+            live[pick] = live.back();
+            live.pop_back();
+        }
+        return static_cast<std::size_t>(-1);
+    };
+
+    LatencyHistogram histograms[kOperationCount];
+    LatencyHistogram all;
+    std::chrono::nanoseconds busy{0};
+
+    for (std::size_t i = 0; i < config.operations; ++i)
+    {
+        std::uint64_t r = roll(rng);
+        int op = 0;
+        while (r >= static_cast<std::uint64_t>(config.mix[op]))
+        {
+            r -= static_cast<std::uint64_t>(config.mix[op]);
+            ++op;
+        }
+
+        OrderSide side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+        std::size_t pick = (op == kCancel || op == kModify) ? pickLive() : 0;
+        if ((op == kCancel || op == kModify) && pick == static_cast<std::size_t>(-1))
+        {
+            op = kAdd;
+        }
+
+        Clock::time_point start;
+        Clock::time_point end;
+        switch (op)
+        {
+        case kAdd:
+        {
+            double price = passivePrice(side);
+            remaining[nextId] = quantity(rng);
+            sides[nextId] = side;
+            start = Clock::now();
+            book.addOrder(nextId, side, price, remaining[nextId]);
+            end = Clock::now();
+            live.push_back(nextId++);
+            break;
+        }
+        case kCancel:
+        {
+            std::uint64_t id = live[pick];
+            start = Clock::now();
+            book.cancelOrder(id);
+            end = Clock::now();
+            remaining[id] = 0;
+            live[pick] = live.back();
+            live.pop_back();
+            break;
+        }
+        case kModify:
+        {
+            // Re-price onto the order's own side of mid; residue left by aggressive
+            // adds can still rest there, so the modify may trade. Fills reported by
+            // the listener are subtracted from the new quantity.
+            std::uint64_t id = live[pick];
+            double newPrice = passivePrice(sides[id]);
+            remaining[id] = quantity(rng);
+            start = Clock::now();
+            book.modifyOrder(id, newPrice, remaining[id]);
+            end = Clock::now();
+            if (remaining[id] == 0)
+            {
+                live[pick] = live.back();
+                live.pop_back();
+            }
+            break;
+        }
+        default:
+        {
+            // Cross up to a quarter of the band into the opposite side
+            Price ticks = side == OrderSide::BUY ? mid + offset(rng) / 4 : mid - offset(rng) / 4;
+            remaining[nextId] = quantity(rng);
+            sides[nextId] = side;
+            start = Clock::now();
+            book.addOrder(nextId, side, book.toPrice(ticks), remaining[nextId]);
+            end = Clock::now();
+            live.push_back(nextId++);
+            break;
+        }
+        }
+
+        auto elapsed = end - start;
+        busy += elapsed;
+        std::uint64_t nanos = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        histograms[op].record(nanos);
+        all.record(nanos);
+    }
+
+    double seconds = std::chrono::duration<double>(busy).count();
+    if (config.json)
+    {
+        printJson(config, seconds, histograms, all);
+    }
+    else
+    {
+        printText(config, seconds, histograms, all);
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "OrderBook.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace orderbook;
+
+/**
+ * Measures snapshot save and load time for a book of N resting orders.
+ * Orders are spread over `levels` price levels per side, so the load
+ * exercises both the level pass and the per-order queue append. Reports the
+ * rebuild cost from a warm page cache, i.e. the engine's share of recovery.
+ *
+ * Usage: orderbook_snapshot_bench [orders=10000000] [levels=1000] [map|ladder]
+ */
+void printUsage()
+{
+    std::cerr << "Usage: orderbook_snapshot_bench [orders=10000000] [levels=1000] [map|ladder]" << std::endl;
+}
+
+// Parses a positive decimal count; rejects signs, trailing garbage and zero
+bool parseCount(const char *text, std::size_t &out)
+{
+    if (text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    char *end = nullptr;
+    const unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end != '\0' || value == 0)
+    {
+        return false;
+    }
+    out = static_cast<std::size_t>(value);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    std::size_t orders = 10000000;
+    std::size_t levels = 1000;
+    bool ladder = false;
+    if (argc > 4 || (argc > 1 && !parseCount(argv[1], orders)) || (argc > 2 && !parseCount(argv[2], levels)))
+    {
+        printUsage();
+        return 1;
+    }
+    if (argc > 3)
+    {
+        const std::string backend = argv[3];
+        if (backend != "map" && backend != "ladder")
+        {
+            printUsage();
+            return 1;
+        }
+        ladder = backend == "ladder";
+    }
+
+    BookOptions options;
+    options.levelStorage = ladder ? LevelStorage::Ladder : LevelStorage::Map;
+    options.ladderTicks = levels * 2 + 2;
+    options.expectedOrders = orders;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "orderbook_snapshot_bench.bin").string();
+
+    OrderBook book(options);
+    const Price mid = 1000000;
+    for (std::size_t i = 0; i < orders; ++i)
+    {
+        OrderSide side = (i & 1) ? OrderSide::BUY : OrderSide::SELL;
+        Price offset = static_cast<Price>(1 + (i / 2) % levels);
+        Price ticks = side == OrderSide::BUY ? mid - offset : mid + offset;
+        book.addOrder(i + 1, side, book.toPrice(ticks), 10);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    book.saveSnapshot(path);
+    double saveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    OrderBook restored(options);
+    start = std::chrono::steady_clock::now();
+    restored.loadSnapshot(path);
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Snapshot of " << orders << " orders over " << levels << " levels/side ("
+              << (ladder ? "ladder" : "map") << ")" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  file size: " << std::filesystem::file_size(path) / (1024.0 * 1024.0) << " MiB" << std::endl;
+    std::cout << "  save:      " << saveSeconds * 1e3 << " ms" << std::endl;
+    std::cout << "  load:      " << loadSeconds * 1e3 << " ms ("
+              << std::setprecision(1) << loadSeconds * 1e9 / static_cast<double>(orders) << " ns/order)" << std::endl;
+
+    if (restored.getOrderCount() != book.getOrderCount() || !(restored.getTopOfBook() == book.getTopOfBook()))
+    {
+        std::cerr << "restored book does not match" << std::endl;
+        return 1;
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
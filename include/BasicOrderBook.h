@@ -0,0 +1,1598 @@
+#pragma once
+
+#include "BookListener.h"
+#include "BookSide.h"
+#include "DepthFeed.h"
+#include "EngineClock.h"
+#include "Journal.h"
+#include "Order.h"
+#include "OrderIdIndex.h"
+#include "OrderPool.h"
+#include "OrderRequest.h"
+#include "PriceLevel.h"
+#include "Snapshot.h"
+#include "TopOfBook.h"
+#include "Trade.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace orderbook
+{
+
+    /**
+     * Per-book configuration
+     */
+    struct BookOptions
+    {
+        double tickSize = 0.01;                                  // Minimum price increment
+        LevelStorage levelStorage = LevelStorage::Map;           // Price level backend for both sides
+        std::size_t ladderTicks = BookSide::kDefaultLadderTicks; // Initial ladder window (Ladder only)
+        std::size_t maxLadderTicks = BookSide::kDefaultMaxLadderTicks; // Largest ladder window; prices beyond it are rejected (Ladder only)
+        std::size_t expectedOrders = 0;                          // Pre-size order storage and id index
+        ClockSource clock = ClockSource::Tsc;                    // Timestamp source for orders and trades
+        JournalWriter *journal = nullptr;                        // Write-ahead journal for accepted commands (not owned)
+        DepthFeed *depthFeed = nullptr;                          // Top-N depth published after each message (not owned)
+    };
+
+    namespace detail
+    {
+        template <typename Listener, typename = void>
+        struct HasTradeBatchHook : std::false_type
+        {
+        };
+
+        template <typename Listener>
+        struct HasTradeBatchHook<Listener, std::void_t<decltype(std::declval<Listener &>().onTradeBatch(
+                                               std::declval<const Trade *>(), std::size_t{}))>> : std::true_type
+        {
+        };
+
+        // True while Listener keeps BookListener's no-op hook, so a batch need
+        // not flush buffered trades ahead of it
+        template <typename Listener, typename = void>
+        struct InheritsAcceptedHook : std::false_type
+        {
+        };
+
+        template <typename Listener>
+        struct InheritsAcceptedHook<Listener, std::enable_if_t<std::is_same<
+                                                  decltype(&Listener::onOrderAccepted),
+                                                  void (BookListener::*)(const Order &)>::value>> : std::true_type
+        {
+        };
+
+        template <typename Listener, typename = void>
+        struct InheritsCancelHook : std::false_type
+        {
+        };
+
+        template <typename Listener>
+        struct InheritsCancelHook<Listener, std::enable_if_t<std::is_same<
+                                                decltype(&Listener::onCancel),
+                                                void (BookListener::*)(const Order &)>::value>> : std::true_type
+        {
+        };
+    } // namespace detail
+
+    /**
+     * Limit order book for a single instrument, parameterised on a
+     * compile-time listener. The listener's hooks are called directly (not
+     * through std::function or a virtual), so they inline into the match loop;
+     * see BookListener for the hook set. OrderBook is the instantiation that
+     * forwards trades to a std::function callback.
+     */
+    template <typename Listener>
+    class BasicOrderBook
+    {
+    public:
+        using OrderPtr = std::shared_ptr<Order>;
+        using OrderMap = OrderIdIndex;
+        using PriceLevelMap = BookSide::PriceLevelMap;
+        using ListenerType = Listener;
+
+        static constexpr double kDefaultTickSize = 0.01;
+
+        /**
+         * Create an order book for a single instrument
+         * @param tickSize Minimum price increment; all prices are stored as integer ticks
+         */
+        explicit BasicOrderBook(double tickSize = kDefaultTickSize);
+
+        /**
+         * Create an order book with explicit options
+         * @param options Tick size and price level backend
+         * @param listener Receives book events
+         */
+        explicit BasicOrderBook(const BookOptions &options, Listener listener = Listener());
+        ~BasicOrderBook() = default;
+
+        // Disable copy constructor and assignment operator
+        BasicOrderBook(const BasicOrderBook &) = delete;
+        BasicOrderBook &operator=(const BasicOrderBook &) = delete;
+
+        // Move constructor and assignment operator
+        BasicOrderBook(BasicOrderBook &&other) noexcept;
+        BasicOrderBook &operator=(BasicOrderBook &&other) noexcept;
+
+        /**
+         * Add an order to the order book
+         * The order is copied into engine-owned storage; the caller's object is
+         * not retained or updated by the book.
+         * @param order The order to add
+         * @return true if order was added successfully, false otherwise
+         */
+        bool addOrder(const Order &order);
+
+        /**
+         * Add an order held by a shared pointer (compatibility overload)
+         * @param order The order to add; copied into engine-owned storage
+         * @return true if order was added successfully, false otherwise
+         */
+        bool addOrder(const OrderPtr &order);
+
+        /**
+         * Add an order built directly in engine-owned storage.
+         * No Order object, heap allocation or clock read is needed on the
+         * caller side; the engine stamps the arrival time itself.
+         * @param orderId Unique order ID
+         * @param side Order side
+         * @param price Limit price
+         * @param quantity Order quantity
+         * @param timeInForce GoodTillCancel rests any remainder; ImmediateOrCancel
+         *        and FillOrKill trade on arrival only and never touch the resting book
+         * @return OrderResult::Accepted, OrderResult::Killed for an unfillable
+         *         fill-or-kill, or the reason the order was rejected (InvalidPrice
+         *         for a price that is not finite or not on the tick grid)
+         */
+        OrderResult addOrder(std::uint64_t orderId, OrderSide side, double price, std::uint64_t quantity,
+                             TimeInForce timeInForce = TimeInForce::GoodTillCancel);
+
+        /**
+         * Add a market order: it sweeps the opposite side at any price, and
+         * whatever cannot fill on arrival is cancelled rather than rested
+         * @param orderId Unique order ID
+         * @param side Order side
+         * @param quantity Order quantity
+         * @param timeInForce FillOrKill to trade only if the whole quantity
+         *        fills; anything else behaves as ImmediateOrCancel
+         * @return OrderResult::Accepted, OrderResult::Killed for an unfillable
+         *         fill-or-kill, or the reason the order was rejected
+         */
+        OrderResult addMarketOrder(std::uint64_t orderId, OrderSide side, std::uint64_t quantity,
+                                   TimeInForce timeInForce = TimeInForce::ImmediateOrCancel);
+
+        /**
+         * Add an iceberg order: it matches with its full quantity on arrival,
+         * then rests showing at most peakQuantity. Each time the displayed
+         * peak fills, the next one is taken from the hidden reserve and joins
+         * the back of the queue. Level depth, the top of book and the depth
+         * feed count the displayed quantity only; a fill-or-kill sizes
+         * against displayed quantity too.
+         * @param orderId Unique order ID
+         * @param side Order side
+         * @param price Limit price
+         * @param quantity Total quantity, displayed plus hidden
+         * @param peakQuantity Display size
+         * @return OrderResult::Accepted, or the reason the order was rejected
+         *         (InvalidQuantity also for a zero peak)
+         */
+        OrderResult addIcebergOrder(std::uint64_t orderId, OrderSide side, double price, std::uint64_t quantity,
+                                    std::uint64_t peakQuantity);
+
+        /**
+         * Cancel an existing order
+         * @param orderId The ID of the order to cancel
+         * @return true if order was found and cancelled, false otherwise
+         */
+        bool cancelOrder(std::uint64_t orderId);
+
+        /**
+         * Modify an existing order. Reducing the quantity (or leaving it
+         * unchanged) at the same price is done in place and keeps the
+         * order's queue position; a price change or size increase re-enters
+         * the order at the back of its new level and may match. For an
+         * iceberg, newQuantity is the new total; a reduction comes out of
+         * the hidden reserve first. A zero quantity is rejected; remove an
+         * order with cancelOrder.
+         * @param orderId The ID of the order to modify
+         * @param newPrice The new price for the order
+         * @param newQuantity The new quantity for the order
+         * @return true if order was modified successfully, false otherwise
+         */
+        bool modifyOrder(std::uint64_t orderId, double newPrice, std::uint64_t newQuantity);
+
+        /**
+         * Process a burst of commands in one call.
+         * Commands are applied in order with the same semantics as the single
+         * calls, but trades are buffered and delivered to the listener once at
+         * the end of the batch, and the top of book is refreshed (and a change
+         * published) once for the whole batch. Buffered trades are flushed
+         * early ahead of an overridden onOrderAccepted or onCancel, so events
+         * still reach the listener in the order they happened.
+         * @param requests Commands to apply
+         * @param count Number of commands
+         * @param results Caller-provided array of `count` entries receiving each command's outcome
+         * @return Number of commands accepted
+         */
+        std::size_t submitBatch(const OrderRequest *requests, std::size_t count, OrderResult *results);
+
+        /**
+         * Re-apply commands read back from this book's journal, e.g. the tail
+         * after loadSnapshot(), so that the book can carry on live. Behaves
+         * like submitBatch, except that every command is stamped with its
+         * recorded timestamp whatever the clock source, and nothing is
+         * appended to the journal, which already holds these records.
+         * @param requests Commands from readJournal, in journal order
+         * @param count Number of commands
+         * @param results Caller-provided array of `count` entries receiving each command's outcome
+         * @return Number of commands accepted
+         */
+        std::size_t replayBatch(const OrderRequest *requests, std::size_t count, OrderResult *results);
+
+        /**
+         * Bulk-load resting orders that cannot trade, e.g. the start-of-day
+         * GTC book. The non-crossing invariant is checked once for the whole
+         * batch (against itself and the current book), then the orders are
+         * sorted by level and the levels built in a single pass without
+         * matching. Time priority within a level follows input order.
+         * Each order is reported through onOrderAccepted and journaled as an
+         * add; the top of book is refreshed once. All-or-nothing.
+         * @param orders Add requests (type is ignored); timestamp is used only on ClockSource::Replay
+         * @param count Number of orders
+         * @throws std::invalid_argument on a zero quantity, a price off the tick
+         *         grid or beyond the ladder cap, a duplicate id, or if any buy
+         *         would meet any sell; the book is then unchanged
+         */
+        void loadRestingOrders(const OrderRequest *orders, std::size_t count);
+
+        /**
+         * Get the cached best bid/offer with aggregate size at each touch.
+         * The cache is refreshed once at the end of every inbound message.
+         * @return Top of book in ticks
+         */
+        const TopOfBook &getTopOfBook() const;
+
+        /**
+         * Get the best bid price
+         * @return The highest bid price, or nullopt if no bids exist
+         */
+        std::optional<double> getBestBid() const;
+
+        /**
+         * Get the best ask price
+         * @return The lowest ask price, or nullopt if no asks exist
+         */
+        std::optional<double> getBestAsk() const;
+
+        /**
+         * Get the spread between best bid and ask
+         * @return The spread, or nullopt if either side is empty
+         */
+        std::optional<double> getSpread() const;
+
+        /**
+         * Get market depth for a given price level in O(1)
+         * @param price The price level to query
+         * @param side The side (buy/sell) to query
+         * @return The total quantity at the price level
+         */
+        std::uint64_t getDepthAtPrice(double price, OrderSide side) const;
+
+        /**
+         * Get the number of orders resting at a price level
+         * @param price The price level to query
+         * @param side The side (buy/sell) to query
+         * @return The order count at the price level
+         */
+        std::size_t getOrderCountAtPrice(double price, OrderSide side) const;
+
+        /**
+         * Get total number of orders in the book
+         * @return Total order count
+         */
+        std::size_t getOrderCount() const;
+
+        /**
+         * Get the number of order slots taken from the pool. Only resting
+         * orders hold one, so this always equals getOrderCount().
+         * @return Pool slots in use
+         */
+        std::size_t getPooledOrderCount() const;
+
+        /**
+         * Access the book's time source. On ClockSource::Replay, set the
+         * recorded time here before each single-message call; submitBatch and
+         * addOrder(const Order&) take it from the request or order instead.
+         * @return The engine clock
+         */
+        EngineClock &clock();
+        const EngineClock &clock() const;
+
+        /**
+         * Access the listener receiving this book's events
+         * @return The listener instance
+         */
+        Listener &listener();
+        const Listener &listener() const;
+
+        /**
+         * The journal accepted commands are written to, if any
+         */
+        JournalWriter *journal() const;
+
+        /**
+         * Journal sequence of the last command this book journaled (0: none).
+         * The command, and every one before it, is on disk once the journal's
+         * durableSequence() has reached this value.
+         */
+        std::uint64_t journalSequence() const;
+
+        /**
+         * Clear all orders from the book. No onCancel fires; on a journaled
+         * book the clear is journaled so that replay empties the book too.
+         */
+        void clear();
+
+        /**
+         * Write every resting order to a binary snapshot file (see
+         * SnapshotHeader for the layout). When the book has a journal, the
+         * snapshot records the last journal sequence it reflects; it first
+         * waits for that record to be durable, so a snapshot never covers a
+         * command the journal has not stored.
+         * @param path Destination; replaced atomically
+         * @throws std::runtime_error on I/O failure, or if the journal fails
+         *         before catching up
+         */
+        void saveSnapshot(const std::string &path) const;
+
+        /**
+         * Replace the book's contents with a snapshot.
+         * The file is memory-mapped and its levels are rebuilt in one pass
+         * with their queue order and sequence numbers intact; nothing is
+         * re-matched and no listener hook other than a final top-of-book
+         * change fires.
+         * @param path Snapshot written by saveSnapshot
+         * @return The journal sequence recorded in the snapshot; replay
+         *         journal records after it to catch up
+         * @throws std::runtime_error if the file is invalid, was written with
+         *         a different tick size, its contents are inconsistent, or its
+         *         prices do not fit the ladder window cap (the book is left
+         *         empty)
+         */
+        std::uint64_t loadSnapshot(const std::string &path);
+
+        /**
+         * Get the tick size this book was created with
+         * @return The minimum price increment
+         */
+        double getTickSize() const;
+
+        /**
+         * Convert a decimal price to ticks, rounding to the nearest tick
+         * @param price The decimal price
+         * @return The price in ticks
+         */
+        Price toTicks(double price) const;
+
+        /**
+         * Convert a price in ticks back to a decimal price
+         * @param ticks The price in ticks
+         * @return The decimal price
+         */
+        double toPrice(Price ticks) const;
+
+    private:
+        // Price grid
+        double tickSize_;
+        double ticksPerUnit_; // 1 / tickSize_, kept to convert with a single multiply/divide
+
+        // Monotonic arrival counter stamped on every order entering a level;
+        // unlike wall-clock time it never ties, so levels are append-only FIFOs
+        std::uint64_t nextSequence_ = 1;
+
+        // Time source, read once per inbound message into messageTime_ and
+        // stamped on the order and every trade the message produces
+        EngineClock clock_;
+        std::uint64_t messageTime_ = 0;
+
+        // Every accepted command is queued here before it is applied
+        JournalWriter *journal_;
+        std::uint64_t journalSequence_ = 0;
+
+        // Top levels are republished here for reader threads
+        DepthFeed *depthFeed_;
+
+        // Data structures
+        OrderPool pool_;     // Owns every resting order; handles are stable raw pointers
+        OrderMap orders_;    // All orders by ID for O(1) lookup
+        BookSide bids_;      // Buy orders by price level
+        BookSide asks_;      // Sell orders by price level
+        TopOfBook top_;      // Cached touch, refreshed once per inbound message
+
+        // Event sink
+        Listener listener_;
+
+        // Set by replayBatch: recorded timestamps are used and nothing is journaled
+        bool replaying_ = false;
+
+        // Trades held back while a batch is in progress; reused across batches
+        bool batching_ = false;
+        std::vector<Trade> tradeBuffer_;
+
+        // Records ahead of the current one whose id index slot loadSide prefetches
+        static constexpr std::uint64_t kLoadPrefetchDistance = 16;
+
+        // Helper methods
+        bool toGridTicks(double price, Price &ticks) const;
+        OrderResult processAdd(std::uint64_t orderId, OrderSide side, double price, std::uint64_t quantity,
+                               OrderType orderType = OrderType::Limit,
+                               TimeInForce timeInForce = TimeInForce::GoodTillCancel,
+                               std::uint64_t peakQuantity = 0);
+        std::uint64_t availableQuantity(OrderSide side, Price limit, std::uint64_t needed) const;
+        OrderResult processCancel(std::uint64_t orderId);
+        OrderResult processModify(std::uint64_t orderId, double newPrice, std::uint64_t newQuantity);
+        OrderResult processClear();
+        void flushTrades();
+        void notifyAccepted(const Order &order);
+        void notifyCancel(const Order &order);
+        void releaseAll();
+        void loadSide(BookSide &side, OrderSide orderSide, const SnapshotRecord *records, std::uint64_t count,
+                      std::uint64_t sequenceLimit);
+        void journalCommand(RequestType type, OrderSide side, std::uint64_t orderId, double price,
+                            std::uint64_t quantity, OrderType orderType = OrderType::Limit,
+                            TimeInForce timeInForce = TimeInForce::GoodTillCancel, std::uint64_t peakQuantity = 0);
+        void matchOrders(Order &newOrder, bool anyPrice = false);
+        void showPeak(Order &order, std::uint64_t quantity);
+        void removeOrderFromPriceLevel(Order &order);
+        void addOrderToPriceLevel(Order &order);
+        BookSide &getBookSide(OrderSide side);
+        const BookSide &getBookSide(OrderSide side) const;
+        void executeTrade(const Order &buyOrder, const Order &sellOrder, std::uint64_t quantity);
+        void refreshTopOfBook();
+        void publishDepth();
+    };
+
+    // ---------------------------------------------------------------------
+    // Implementation (header-only so custom listeners inline into the engine)
+    // ---------------------------------------------------------------------
+
+    template <typename Listener>
+    BasicOrderBook<Listener>::BasicOrderBook(double tickSize)
+        : BasicOrderBook(BookOptions{tickSize})
+    {
+    }
+
+    template <typename Listener>
+    BasicOrderBook<Listener>::BasicOrderBook(const BookOptions &options, Listener listener)
+        : tickSize_(options.tickSize),
+          ticksPerUnit_(1.0 / options.tickSize),
+          clock_(options.clock),
+          journal_(options.journal),
+          depthFeed_(options.depthFeed),
+          orders_(options.expectedOrders),
+          bids_(OrderSide::BUY, options.levelStorage, options.ladderTicks, options.maxLadderTicks),
+          asks_(OrderSide::SELL, options.levelStorage, options.ladderTicks, options.maxLadderTicks),
+          listener_(std::move(listener))
+    {
+        if (!(tickSize_ > 0.0) || !std::isfinite(ticksPerUnit_))
+        {
+            throw std::invalid_argument("Tick size must be positive");
+        }
+
+        pool_.reserve(options.expectedOrders);
+    }
+
+    template <typename Listener>
+    BasicOrderBook<Listener>::BasicOrderBook(BasicOrderBook &&other) noexcept
+        : tickSize_(other.tickSize_),
+          ticksPerUnit_(other.ticksPerUnit_),
+          nextSequence_(other.nextSequence_),
+          clock_(other.clock_),
+          messageTime_(other.messageTime_),
+          journal_(std::exchange(other.journal_, nullptr)),
+          journalSequence_(other.journalSequence_),
+          depthFeed_(std::exchange(other.depthFeed_, nullptr)),
+          pool_(std::move(other.pool_)),
+          orders_(std::move(other.orders_)),
+          bids_(std::move(other.bids_)),
+          asks_(std::move(other.asks_)),
+          top_(std::exchange(other.top_, TopOfBook{})),
+          listener_(std::move(other.listener_)),
+          tradeBuffer_(std::move(other.tradeBuffer_))
+    {
+    }
+
+    template <typename Listener>
+    BasicOrderBook<Listener> &BasicOrderBook<Listener>::operator=(BasicOrderBook &&other) noexcept
+    {
+        if (this != &other)
+        {
+            tickSize_ = other.tickSize_;
+            ticksPerUnit_ = other.ticksPerUnit_;
+            nextSequence_ = other.nextSequence_;
+            clock_ = other.clock_;
+            messageTime_ = other.messageTime_;
+            journal_ = std::exchange(other.journal_, nullptr);
+            journalSequence_ = other.journalSequence_;
+            depthFeed_ = std::exchange(other.depthFeed_, nullptr);
+            pool_ = std::move(other.pool_);
+            orders_ = std::move(other.orders_);
+            bids_ = std::move(other.bids_);
+            asks_ = std::move(other.asks_);
+            top_ = std::exchange(other.top_, TopOfBook{});
+            listener_ = std::move(other.listener_);
+            tradeBuffer_ = std::move(other.tradeBuffer_);
+        }
+        return *this;
+    }
+
+    template <typename Listener>
+    bool BasicOrderBook<Listener>::addOrder(const Order &order)
+    {
+        // A replayed order carries its recorded time
+        if (clock_.source() == ClockSource::Replay)
+        {
+            clock_.set(order.timestamp);
+        }
+        messageTime_ = clock_.now();
+        if (processAdd(order.orderId, order.side, order.price, order.quantity) != OrderResult::Accepted)
+        {
+            return false;
+        }
+
+        refreshTopOfBook();
+        return true;
+    }
+
+    template <typename Listener>
+    bool BasicOrderBook<Listener>::addOrder(const OrderPtr &order)
+    {
+        return order && addOrder(*order);
+    }
+
+    template <typename Listener>
+    OrderResult BasicOrderBook<Listener>::addOrder(std::uint64_t orderId, OrderSide side, double price, std::uint64_t quantity,
+                                                   TimeInForce timeInForce)
+    {
+        messageTime_ = clock_.now();
+        const OrderResult result = processAdd(orderId, side, price, quantity, OrderType::Limit, timeInForce);
+        if (result == OrderResult::Accepted)
+        {
+            refreshTopOfBook();
+        }
+        return result;
+    }
+
+    template <typename Listener>
+    OrderResult BasicOrderBook<Listener>::addMarketOrder(std::uint64_t orderId, OrderSide side, std::uint64_t quantity,
+                                                         TimeInForce timeInForce)
+    {
+        messageTime_ = clock_.now();
+        const OrderResult result = processAdd(orderId, side, 0.0, quantity, OrderType::Market, timeInForce);
+        if (result == OrderResult::Accepted)
+        {
+            refreshTopOfBook();
+        }
+        return result;
+    }
+
+    template <typename Listener>
+    OrderResult BasicOrderBook<Listener>::addIcebergOrder(std::uint64_t orderId, OrderSide side, double price,
+                                                          std::uint64_t quantity, std::uint64_t peakQuantity)
+    {
+        if (peakQuantity == 0)
+        {
+            return OrderResult::InvalidQuantity;
+        }
+
+        messageTime_ = clock_.now();
+        const OrderResult result = processAdd(orderId, side, price, quantity, OrderType::Limit,
+                                              TimeInForce::GoodTillCancel, peakQuantity);
+        if (result == OrderResult::Accepted)
+        {
+            refreshTopOfBook();
+        }
+        return result;
+    }
+
+    template <typename Listener>
+    bool BasicOrderBook<Listener>::cancelOrder(std::uint64_t orderId)
+    {
+        messageTime_ = clock_.now();
+        if (processCancel(orderId) != OrderResult::Accepted)
+        {
+            return false;
+        }
+
+        refreshTopOfBook();
+        return true;
+    }
+
+    template <typename Listener>
+    bool BasicOrderBook<Listener>::modifyOrder(std::uint64_t orderId, double newPrice, std::uint64_t newQuantity)
+    {
+        messageTime_ = clock_.now();
+        if (processModify(orderId, newPrice, newQuantity) != OrderResult::Accepted)
+        {
+            return false;
+        }
+
+        refreshTopOfBook();
+        return true;
+    }
+
+    template <typename Listener>
+    std::size_t BasicOrderBook<Listener>::submitBatch(const OrderRequest *requests, std::size_t count, OrderResult *results)
+    {
+        std::size_t accepted = 0;
+        // One clock read stamps every order and trade in the batch; in replay
+        // each command carries its own recorded time instead
+        messageTime_ = clock_.now();
+        batching_ = true;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const OrderRequest &request = requests[i];
+            if (replaying_)
+            {
+                messageTime_ = request.timestamp;
+            }
+            else if (clock_.source() == ClockSource::Replay)
+            {
+                clock_.set(request.timestamp);
+                messageTime_ = clock_.now();
+            }
+
+            switch (request.type)
+            {
+            case RequestType::Add:
+                results[i] = processAdd(request.orderId, request.side, request.price, request.quantity,
+                                        request.orderType, request.timeInForce, request.peakQuantity);
+                break;
+            case RequestType::Cancel:
+                results[i] = processCancel(request.orderId);
+                break;
+            case RequestType::Modify:
+                results[i] = processModify(request.orderId, request.price, request.quantity);
+                break;
+            case RequestType::Clear:
+                results[i] = processClear();
+                break;
+            }
+            accepted += results[i] == OrderResult::Accepted;
+        }
+
+        batching_ = false;
+        flushTrades();
+        refreshTopOfBook();
+        return accepted;
+    }
+
+    template <typename Listener>
+    std::size_t BasicOrderBook<Listener>::replayBatch(const OrderRequest *requests, std::size_t count,
+                                                      OrderResult *results)
+    {
+        replaying_ = true;
+        const std::size_t accepted = submitBatch(requests, count, results);
+        replaying_ = false;
+        return accepted;
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::loadRestingOrders(const OrderRequest *orders, std::size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        messageTime_ = clock_.now();
+
+        // Validation pass: the batch may only rest if its highest bid stays
+        // below its lowest ask, including what is already in the book
+        std::vector<Price> ticks(count);
+        Price bidHigh = std::numeric_limits<Price>::min(), bidLow = std::numeric_limits<Price>::max();
+        Price askHigh = std::numeric_limits<Price>::min(), askLow = std::numeric_limits<Price>::max();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (orders[i].quantity == 0)
+            {
+                throw std::invalid_argument("Bulk load order has zero quantity");
+            }
+            if (!toGridTicks(orders[i].price, ticks[i]))
+            {
+                throw std::invalid_argument("Bulk load order price is not on the tick grid");
+            }
+            if (orders[i].side == OrderSide::BUY)
+            {
+                bidHigh = std::max(bidHigh, ticks[i]);
+                bidLow = std::min(bidLow, ticks[i]);
+            }
+            else
+            {
+                askHigh = std::max(askHigh, ticks[i]);
+                askLow = std::min(askLow, ticks[i]);
+            }
+        }
+        if ((bidHigh >= bidLow && !bids_.canHold(bidLow, bidHigh)) || (askHigh >= askLow && !asks_.canHold(askLow, askHigh)))
+        {
+            throw std::invalid_argument("Bulk load orders span more ticks than the ladder window cap");
+        }
+        const Price highestBid = bids_.empty() ? bidHigh : std::max(bidHigh, bids_.best()->price);
+        const Price lowestAsk = asks_.empty() ? askLow : std::min(askLow, asks_.best()->price);
+        if (highestBid >= lowestAsk)
+        {
+            throw std::invalid_argument("Bulk load orders would cross the book");
+        }
+
+        // Order of placement: bids then asks, each best level first, input
+        // order within a level (time priority). Slot 0 is the best bid; asks
+        // follow the worst bid. When the batch spans a modest number of ticks
+        // this is a stable counting sort, otherwise a comparison sort
+        const std::uint64_t bidSpan = bidHigh >= bidLow ? static_cast<std::uint64_t>(bidHigh - bidLow) + 1 : 0;
+        const std::uint64_t askSpan = askHigh >= askLow ? static_cast<std::uint64_t>(askHigh - askLow) + 1 : 0;
+        auto slotOf = [&](std::size_t i) -> std::uint64_t
+        {
+            return orders[i].side == OrderSide::BUY ? static_cast<std::uint64_t>(bidHigh - ticks[i])
+                                                    : bidSpan + static_cast<std::uint64_t>(ticks[i] - askLow);
+        };
+
+        std::vector<std::size_t> byLevel(count);
+        const std::uint64_t slots = bidSpan + askSpan;
+        if (bidSpan <= 4 * count + 4096 && askSpan <= 4 * count + 4096)
+        {
+            std::vector<std::size_t> start(slots + 1, 0);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                ++start[slotOf(i) + 1];
+            }
+            for (std::uint64_t slot = 0; slot < slots; ++slot)
+            {
+                start[slot + 1] += start[slot];
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                byLevel[start[slotOf(i)]++] = i;
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                byLevel[i] = i;
+            }
+            std::stable_sort(byLevel.begin(), byLevel.end(), [&](std::size_t a, std::size_t b)
+                             { return slotOf(a) < slotOf(b); });
+        }
+
+        pool_.reserve(pool_.inUse() + count);
+        orders_.reserve(orders_.size() + count);
+
+        // A side that starts empty is built from the far end; otherwise new
+        // levels may interleave with existing ones and are looked up
+        const bool bidsWereEmpty = bids_.empty();
+        const bool asksWereEmpty = asks_.empty();
+        const std::uint64_t firstSequence = nextSequence_;
+        std::vector<Order *> placed(count); // By input index
+
+        PriceLevel *level = nullptr;
+        OrderSide levelSide = OrderSide::BUY;
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            const std::size_t i = byLevel[n];
+            const OrderRequest &request = orders[i];
+            const std::uint64_t timestamp = clock_.source() == ClockSource::Replay ? request.timestamp : messageTime_;
+
+            Order *order = pool_.create(request.orderId, request.side, request.price, request.quantity, timestamp);
+            order->peakQuantity = request.peakQuantity;
+            showPeak(*order, request.quantity);
+            order->priceTicks = ticks[i];
+            order->sequence = firstSequence + i;
+            if (!orders_.insert(request.orderId, order))
+            {
+                // Undo the orders placed so far; none has been reported yet
+                pool_.destroy(order);
+                for (std::size_t undo = 0; undo < n; ++undo)
+                {
+                    Order *undone = placed[byLevel[undo]];
+                    removeOrderFromPriceLevel(*undone);
+                    orders_.erase(undone->orderId);
+                    pool_.destroy(undone);
+                }
+                throw std::invalid_argument("Bulk load order id is already in use");
+            }
+            placed[i] = order;
+
+            if (!level || level->price != ticks[i] || levelSide != request.side)
+            {
+                BookSide &side = getBookSide(request.side);
+                const bool wasEmpty = request.side == OrderSide::BUY ? bidsWereEmpty : asksWereEmpty;
+                level = wasEmpty ? &side.appendWorst(ticks[i]) : &side.findOrCreate(ticks[i]);
+                levelSide = request.side;
+            }
+            level->pushBack(order);
+        }
+        nextSequence_ = firstSequence + count;
+
+        // Report and journal in input order, which is also sequence order
+        for (const Order *order : placed)
+        {
+            messageTime_ = order->timestamp;
+            journalCommand(RequestType::Add, order->side, order->orderId, order->price,
+                           order->quantity + order->hiddenQuantity, OrderType::Limit, TimeInForce::GoodTillCancel,
+                           order->peakQuantity);
+            notifyAccepted(*order);
+        }
+
+        refreshTopOfBook();
+    }
+
+    template <typename Listener>
+    OrderResult BasicOrderBook<Listener>::processAdd(std::uint64_t orderId, OrderSide side, double price,
+                                                     std::uint64_t quantity, OrderType orderType,
+                                                     TimeInForce timeInForce, std::uint64_t peakQuantity)
+    {
+        if (quantity == 0)
+        {
+            return OrderResult::InvalidQuantity;
+        }
+
+        // A limit price must sit on the grid; rounding it could loosen the limit
+        const bool market = orderType == OrderType::Market;
+        Price limitTicks = 0;
+        if (!market && !toGridTicks(price, limitTicks))
+        {
+            return OrderResult::InvalidPrice;
+        }
+
+        // Check if order already exists
+        if (orders_.find(orderId))
+        {
+            return OrderResult::DuplicateId;
+        }
+
+        // A remainder that may rest must have a level to go to
+        if (!market && timeInForce == TimeInForce::GoodTillCancel && !getBookSide(side).canHold(limitTicks))
+        {
+            return OrderResult::PriceOutOfRange;
+        }
+
+        journalCommand(RequestType::Add, side, orderId, price, quantity, orderType, timeInForce, peakQuantity);
+
+        // Match first from a transient order; only a residual that may rest
+        // reaches the pool, the id index and a level
+        Order taker(orderId, side, price, quantity, messageTime_);
+        taker.priceTicks = !market                  ? limitTicks
+                           : side == OrderSide::BUY ? std::numeric_limits<Price>::max()
+                                                    : std::numeric_limits<Price>::min();
+        notifyAccepted(taker);
+
+        // Fill-or-kill checks the level aggregates before any trade happens
+        if (timeInForce == TimeInForce::FillOrKill &&
+            availableQuantity(side, taker.priceTicks, quantity) < quantity)
+        {
+            notifyCancel(taker);
+            return OrderResult::Killed;
+        }
+
+        matchOrders(taker, market);
+        if (taker.quantity == 0)
+        {
+            return OrderResult::Accepted;
+        }
+
+        // Market, IOC and FOK remainders are dropped, not rested
+        if (market || timeInForce != TimeInForce::GoodTillCancel)
+        {
+            notifyCancel(taker);
+            return OrderResult::Accepted;
+        }
+
+        Order *resting = pool_.create(orderId, side, price, taker.quantity, messageTime_);
+        resting->priceTicks = taker.priceTicks;
+        resting->peakQuantity = peakQuantity;
+        showPeak(*resting, taker.quantity);
+        orders_.insert(orderId, resting);
+        addOrderToPriceLevel(*resting);
+
+        return OrderResult::Accepted;
+    }
+
+    template <typename Listener>
+    std::uint64_t BasicOrderBook<Listener>::availableQuantity(OrderSide side, Price limit, std::uint64_t needed) const
+    {
+        // Opposite levels the order could reach, best first, until enough is found
+        std::uint64_t available = 0;
+        getBookSide(side == OrderSide::BUY ? OrderSide::SELL : OrderSide::BUY)
+            .forEachLevel([&](const PriceLevel &level)
+                          {
+                              if (side == OrderSide::BUY ? level.price > limit : level.price < limit)
+                              {
+                                  return false;
+                              }
+                              available += level.totalQuantity;
+                              return available < needed; });
+        return available;
+    }
+
+    template <typename Listener>
+    OrderResult BasicOrderBook<Listener>::processCancel(std::uint64_t orderId)
+    {
+        Order *order = orders_.find(orderId);
+        if (!order)
+        {
+            return OrderResult::UnknownOrder;
+        }
+
+        journalCommand(RequestType::Cancel, order->side, orderId, order->price, 0);
+
+        removeOrderFromPriceLevel(*order);
+        orders_.erase(orderId);
+        notifyCancel(*order);
+        pool_.destroy(order);
+
+        return OrderResult::Accepted;
+    }
+
+    template <typename Listener>
+    OrderResult BasicOrderBook<Listener>::processModify(std::uint64_t orderId, double newPrice, std::uint64_t newQuantity)
+    {
+        Order *order = orders_.find(orderId);
+        if (!order)
+        {
+            return OrderResult::UnknownOrder;
+        }
+
+        // Removing an order is a cancel, with its onCancel; a modify never does it
+        if (newQuantity == 0)
+        {
+            return OrderResult::InvalidQuantity;
+        }
+
+        Price newTicks = 0;
+        if (!toGridTicks(newPrice, newTicks))
+        {
+            return OrderResult::InvalidPrice;
+        }
+        if (!getBookSide(order->side).canHold(newTicks))
+        {
+            return OrderResult::PriceOutOfRange;
+        }
+
+        journalCommand(RequestType::Modify, order->side, orderId, newPrice, newQuantity);
+
+        // Size-down at the same price keeps priority and cannot cross; an
+        // iceberg gives up hidden quantity before displayed
+        if (newTicks == order->priceTicks && newQuantity <= order->quantity + order->hiddenQuantity)
+        {
+            if (newQuantity >= order->quantity)
+            {
+                order->hiddenQuantity = newQuantity - order->quantity;
+            }
+            else
+            {
+                order->hiddenQuantity = 0;
+                order->level->reduce(order, order->quantity - newQuantity);
+            }
+            order->price = newPrice;
+            return OrderResult::Accepted;
+        }
+
+        // Take the order out of its level and match it detached, like a new order
+        removeOrderFromPriceLevel(*order);
+
+        // Update order parameters
+        order->price = newPrice;
+        order->priceTicks = newTicks;
+        order->quantity = newQuantity;
+        order->hiddenQuantity = 0;
+        order->timestamp = messageTime_;
+
+        matchOrders(*order);
+
+        // Only a residual goes back into a level, at the back of its queue
+        if (order->quantity == 0)
+        {
+            orders_.erase(orderId);
+            pool_.destroy(order);
+        }
+        else
+        {
+            showPeak(*order, order->quantity);
+            addOrderToPriceLevel(*order);
+        }
+
+        return OrderResult::Accepted;
+    }
+
+    template <typename Listener>
+    OrderResult BasicOrderBook<Listener>::processClear()
+    {
+        journalCommand(RequestType::Clear, OrderSide::BUY, 0, 0.0, 0);
+        releaseAll();
+        return OrderResult::Accepted;
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::journalCommand(RequestType type, OrderSide side, std::uint64_t orderId,
+                                                  double price, std::uint64_t quantity, OrderType orderType,
+                                                  TimeInForce timeInForce, std::uint64_t peakQuantity)
+    {
+        if (!journal_ || replaying_)
+        {
+            return;
+        }
+
+        OrderRequest request;
+        request.type = type;
+        request.side = side;
+        request.orderType = orderType;
+        request.timeInForce = timeInForce;
+        request.peakQuantity = peakQuantity;
+        request.orderId = orderId;
+        request.price = price;
+        request.quantity = quantity;
+        request.timestamp = messageTime_;
+        journalSequence_ = journal_->append(request);
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::releaseAll()
+    {
+        // Slots go back to the pool so a cleared book can refill without allocating
+        orders_.forEach([this](Order *order)
+                        { pool_.destroy(order); });
+        orders_.clear();
+        bids_.clear();
+        asks_.clear();
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::loadSide(BookSide &side, OrderSide orderSide, const SnapshotRecord *records,
+                                            std::uint64_t count, std::uint64_t sequenceLimit)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // A ladder side must hold the whole price range before any level is built
+        Price low = records[0].priceTicks, high = records[0].priceTicks;
+        for (std::uint64_t i = 1; i < count; ++i)
+        {
+            low = std::min(low, records[i].priceTicks);
+            high = std::max(high, records[i].priceTicks);
+        }
+        if (!side.canHold(low, high))
+        {
+            throw std::runtime_error("Snapshot prices span more ticks than the ladder window cap");
+        }
+
+        // Records arrive best level first and in queue order, so each level
+        // is created once at the far end of the side and only appended to
+        PriceLevel *level = nullptr;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            // Index slots are effectively random; start the miss for a later record now
+            if (i + kLoadPrefetchDistance < count)
+            {
+                orders_.prefetch(records[i + kLoadPrefetchDistance].orderId);
+            }
+            const SnapshotRecord &record = records[i];
+            if (record.quantity == 0 || record.sequence == 0 || record.sequence >= sequenceLimit ||
+                (record.hiddenQuantity != 0 && record.quantity > record.peakQuantity))
+            {
+                throw std::runtime_error("Snapshot holds an invalid order");
+            }
+
+            if (!level || record.priceTicks != level->price)
+            {
+                if (level && (orderSide == OrderSide::BUY ? record.priceTicks > level->price
+                                                          : record.priceTicks < level->price))
+                {
+                    throw std::runtime_error("Snapshot levels are out of price order");
+                }
+                level = &side.appendWorst(record.priceTicks);
+            }
+            else if (record.sequence <= level->tail->sequence)
+            {
+                throw std::runtime_error("Snapshot queue is out of time priority");
+            }
+
+            Order *order = pool_.create(record.orderId, orderSide, record.price, record.quantity, record.timestamp);
+            order->priceTicks = record.priceTicks;
+            order->sequence = record.sequence;
+            order->hiddenQuantity = record.hiddenQuantity;
+            order->peakQuantity = record.peakQuantity;
+            if (!orders_.insert(record.orderId, order))
+            {
+                pool_.destroy(order);
+                throw std::runtime_error("Snapshot holds a duplicate order id");
+            }
+            level->pushBack(order);
+        }
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::notifyAccepted(const Order &order)
+    {
+        // Trades buffered by a batch happened before this event
+        if constexpr (!detail::InheritsAcceptedHook<Listener>::value)
+        {
+            if (batching_)
+            {
+                flushTrades();
+            }
+        }
+        listener_.onOrderAccepted(order);
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::notifyCancel(const Order &order)
+    {
+        if constexpr (!detail::InheritsCancelHook<Listener>::value)
+        {
+            if (batching_)
+            {
+                flushTrades();
+            }
+        }
+        listener_.onCancel(order);
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::flushTrades()
+    {
+        if (tradeBuffer_.empty())
+        {
+            return;
+        }
+
+        if constexpr (detail::HasTradeBatchHook<Listener>::value)
+        {
+            listener_.onTradeBatch(tradeBuffer_.data(), tradeBuffer_.size());
+        }
+        else
+        {
+            for (const Trade &trade : tradeBuffer_)
+            {
+                listener_.onTrade(trade);
+            }
+        }
+        tradeBuffer_.clear();
+    }
+
+    template <typename Listener>
+    const TopOfBook &BasicOrderBook<Listener>::getTopOfBook() const
+    {
+        return top_;
+    }
+
+    template <typename Listener>
+    std::optional<double> BasicOrderBook<Listener>::getBestBid() const
+    {
+        if (!top_.hasBid())
+        {
+            return std::nullopt;
+        }
+        return toPrice(top_.bidPrice); // Highest price
+    }
+
+    template <typename Listener>
+    std::optional<double> BasicOrderBook<Listener>::getBestAsk() const
+    {
+        if (!top_.hasAsk())
+        {
+            return std::nullopt;
+        }
+        return toPrice(top_.askPrice); // Lowest price
+    }
+
+    template <typename Listener>
+    std::optional<double> BasicOrderBook<Listener>::getSpread() const
+    {
+        if (!top_.hasBid() || !top_.hasAsk())
+        {
+            return std::nullopt;
+        }
+
+        // Subtract in ticks so the spread is exact
+        return toPrice(top_.askPrice - top_.bidPrice);
+    }
+
+    template <typename Listener>
+    std::uint64_t BasicOrderBook<Listener>::getDepthAtPrice(double price, OrderSide side) const
+    {
+        const PriceLevel *level = getBookSide(side).find(toTicks(price));
+        return level ? level->totalQuantity : 0;
+    }
+
+    template <typename Listener>
+    std::size_t BasicOrderBook<Listener>::getOrderCountAtPrice(double price, OrderSide side) const
+    {
+        const PriceLevel *level = getBookSide(side).find(toTicks(price));
+        return level ? level->orderCount : 0;
+    }
+
+    template <typename Listener>
+    std::size_t BasicOrderBook<Listener>::getOrderCount() const
+    {
+        return orders_.size();
+    }
+
+    template <typename Listener>
+    std::size_t BasicOrderBook<Listener>::getPooledOrderCount() const
+    {
+        return pool_.inUse();
+    }
+
+    template <typename Listener>
+    EngineClock &BasicOrderBook<Listener>::clock()
+    {
+        return clock_;
+    }
+
+    template <typename Listener>
+    const EngineClock &BasicOrderBook<Listener>::clock() const
+    {
+        return clock_;
+    }
+
+    template <typename Listener>
+    Listener &BasicOrderBook<Listener>::listener()
+    {
+        return listener_;
+    }
+
+    template <typename Listener>
+    const Listener &BasicOrderBook<Listener>::listener() const
+    {
+        return listener_;
+    }
+
+    template <typename Listener>
+    JournalWriter *BasicOrderBook<Listener>::journal() const
+    {
+        return journal_;
+    }
+
+    template <typename Listener>
+    std::uint64_t BasicOrderBook<Listener>::journalSequence() const
+    {
+        return journalSequence_;
+    }
+
+    template <typename Listener>
+    double BasicOrderBook<Listener>::getTickSize() const
+    {
+        return tickSize_;
+    }
+
+    template <typename Listener>
+    Price BasicOrderBook<Listener>::toTicks(double price) const
+    {
+        return static_cast<Price>(std::llround(price * ticksPerUnit_));
+    }
+
+    template <typename Listener>
+    bool BasicOrderBook<Listener>::toGridTicks(double price, Price &ticks) const
+    {
+        // Tolerate floating-point noise, not a price between two ticks
+        constexpr double kGridTolerance = 1e-6; // Fraction of a tick
+        constexpr double kMaxTicks = 9.0e18;    // Within Price range
+        const double scaled = price * ticksPerUnit_;
+        if (!std::isfinite(scaled) || std::fabs(scaled) > kMaxTicks)
+        {
+            return false;
+        }
+        const double nearest = std::nearbyint(scaled);
+        if (std::fabs(scaled - nearest) > kGridTolerance)
+        {
+            return false;
+        }
+        ticks = static_cast<Price>(nearest);
+        return true;
+    }
+
+    template <typename Listener>
+    double BasicOrderBook<Listener>::toPrice(Price ticks) const
+    {
+        // Divide by the integral ticks-per-unit so on-grid prices round-trip exactly
+        return static_cast<double>(ticks) / ticksPerUnit_;
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::clear()
+    {
+        messageTime_ = clock_.now();
+        processClear();
+        refreshTopOfBook();
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::saveSnapshot(const std::string &path) const
+    {
+        auto countOrders = [](const BookSide &side)
+        {
+            std::uint64_t count = 0;
+            side.forEachLevel([&count](const PriceLevel &level)
+                              {
+                                  count += level.orderCount;
+                                  return true; });
+            return count;
+        };
+
+        SnapshotHeader header = makeSnapshotHeader();
+        header.tickSize = tickSize_;
+        header.nextSequence = nextSequence_;
+        header.journalSequence = journal_ ? journal_->appendedSequence() : 0;
+        // Recovery replays the journal after journalSequence: every record up
+        // to it must be on disk before the snapshot can claim it
+        if (journal_ && !journal_->waitDurable(header.journalSequence))
+        {
+            throw std::runtime_error("Journal failed before snapshot '" + path + "' was durable");
+        }
+        header.bidOrders = countOrders(bids_);
+        header.askOrders = countOrders(asks_);
+
+        SnapshotWriter writer(path, header);
+        auto writeSide = [&writer](const BookSide &side)
+        {
+            side.forEachLevel([&writer](const PriceLevel &level)
+                              {
+                                  for (const Order *order = level.head; order; order = order->next)
+                                  {
+                                      writer.append({order->orderId, order->priceTicks, order->quantity,
+                                                     order->timestamp, order->sequence, order->price,
+                                                     order->hiddenQuantity, order->peakQuantity});
+                                  }
+                                  return true; });
+        };
+        writeSide(bids_);
+        writeSide(asks_);
+        writer.finish();
+    }
+
+    template <typename Listener>
+    std::uint64_t BasicOrderBook<Listener>::loadSnapshot(const std::string &path)
+    {
+        MappedSnapshot snapshot(path);
+        const SnapshotHeader &header = snapshot.header();
+        if (header.tickSize != tickSize_)
+        {
+            throw std::runtime_error("Snapshot tick size does not match the book: '" + path + "'");
+        }
+
+        releaseAll();
+        pool_.reserve(header.bidOrders + header.askOrders);
+        orders_.reserve(header.bidOrders + header.askOrders);
+
+        try
+        {
+            loadSide(bids_, OrderSide::BUY, snapshot.records(), header.bidOrders, header.nextSequence);
+            loadSide(asks_, OrderSide::SELL, snapshot.records() + header.bidOrders, header.askOrders,
+                     header.nextSequence);
+            if (!bids_.empty() && !asks_.empty() && bids_.best()->price >= asks_.best()->price)
+            {
+                throw std::runtime_error("Snapshot book is crossed: '" + path + "'");
+            }
+        }
+        catch (...)
+        {
+            releaseAll();
+            refreshTopOfBook();
+            throw;
+        }
+
+        nextSequence_ = header.nextSequence;
+        refreshTopOfBook();
+        return header.journalSequence;
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::matchOrders(Order &newOrder, bool anyPrice)
+    {
+        BookSide &oppositeSide = (newOrder.side == OrderSide::BUY) ? asks_ : bids_;
+
+        while (newOrder.quantity > 0 && !oppositeSide.empty())
+        {
+            // Get the best price level on the opposite side
+            PriceLevel &level = *oppositeSide.best();
+            Price oppositePrice = level.price;
+
+            // A market order takes each level's price as its own, so trades
+            // print at the resting price
+            if (anyPrice)
+            {
+                newOrder.priceTicks = oppositePrice;
+            }
+
+            // Check if prices can match
+            bool canMatch = (newOrder.side == OrderSide::BUY) ? (newOrder.priceTicks >= oppositePrice) : (newOrder.priceTicks <= oppositePrice);
+
+            if (!canMatch)
+            {
+                break;
+            }
+
+            while (!level.empty() && newOrder.quantity > 0)
+            {
+                Order *oppositeOrder = level.front();
+
+                std::uint64_t tradeQuantity = std::min(newOrder.quantity, oppositeOrder->quantity);
+
+                // Execute the trade - ensure correct order of buy/sell
+                if (newOrder.side == OrderSide::BUY)
+                {
+                    executeTrade(newOrder, *oppositeOrder, tradeQuantity);
+                }
+                else
+                {
+                    executeTrade(*oppositeOrder, newOrder, tradeQuantity);
+                }
+
+                // The incoming order is never in a level while it matches
+                newOrder.quantity -= tradeQuantity;
+                level.reduce(oppositeOrder, tradeQuantity);
+
+                // Remove fully filled opposite order and recycle its slot; an
+                // iceberg instead shows its next peak at the back of the queue
+                if (oppositeOrder->quantity == 0)
+                {
+                    level.remove(oppositeOrder);
+                    if (oppositeOrder->hiddenQuantity > 0)
+                    {
+                        showPeak(*oppositeOrder, oppositeOrder->hiddenQuantity);
+                        oppositeOrder->sequence = nextSequence_++;
+                        level.pushBack(oppositeOrder);
+                    }
+                    else
+                    {
+                        orders_.erase(oppositeOrder->orderId);
+                        pool_.destroy(oppositeOrder);
+                    }
+                }
+            }
+
+            // Remove empty price level
+            if (level.empty())
+            {
+                oppositeSide.erase(level);
+            }
+        }
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::showPeak(Order &order, std::uint64_t quantity)
+    {
+        // Split `quantity` (not yet in any level) into the displayed peak and
+        // the hidden reserve
+        const std::uint64_t shown =
+            order.peakQuantity != 0 && order.peakQuantity < quantity ? order.peakQuantity : quantity;
+        order.quantity = shown;
+        order.hiddenQuantity = quantity - shown;
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::removeOrderFromPriceLevel(Order &order)
+    {
+        PriceLevel *level = order.level;
+        if (!level)
+        {
+            return;
+        }
+
+        level->remove(&order);
+
+        // Remove empty price level
+        if (level->empty())
+        {
+            getBookSide(order.side).erase(*level);
+        }
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::addOrderToPriceLevel(Order &order)
+    {
+        PriceLevel &level = getBookSide(order.side).findOrCreate(order.priceTicks);
+
+        // Every entry takes the next sequence number, so appending keeps the
+        // level sorted by time priority without any reordering
+        order.sequence = nextSequence_++;
+        level.pushBack(&order);
+    }
+
+    template <typename Listener>
+    BookSide &BasicOrderBook<Listener>::getBookSide(OrderSide side)
+    {
+        return (side == OrderSide::BUY) ? bids_ : asks_;
+    }
+
+    template <typename Listener>
+    const BookSide &BasicOrderBook<Listener>::getBookSide(OrderSide side) const
+    {
+        return (side == OrderSide::BUY) ? bids_ : asks_;
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::executeTrade(const Order &buyOrder, const Order &sellOrder, std::uint64_t quantity)
+    {
+        // Ensure buyOrder is actually a buy order and sellOrder is a sell order
+        if (buyOrder.side != OrderSide::BUY || sellOrder.side != OrderSide::SELL)
+        {
+            throw std::runtime_error("Invalid trade execution: order sides don't match");
+        }
+
+        // Create trade record; the mid-price may fall on a half tick, so it is
+        // converted back to a decimal price here at the API edge
+        Trade trade(buyOrder.orderId, sellOrder.orderId,
+                    static_cast<double>(buyOrder.priceTicks + sellOrder.priceTicks) / (2.0 * ticksPerUnit_),
+                    quantity, messageTime_);
+
+        if (batching_)
+        {
+            tradeBuffer_.push_back(trade);
+        }
+        else
+        {
+            listener_.onTrade(trade);
+        }
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::refreshTopOfBook()
+    {
+        TopOfBook top;
+        if (const PriceLevel *bid = bids_.best())
+        {
+            top.bidPrice = bid->price;
+            top.bidQuantity = bid->totalQuantity;
+            top.bidOrders = bid->orderCount;
+        }
+        if (const PriceLevel *ask = asks_.best())
+        {
+            top.askPrice = ask->price;
+            top.askQuantity = ask->totalQuantity;
+            top.askOrders = ask->orderCount;
+        }
+
+        // Only a real change of the touch is published
+        if (top != top_)
+        {
+            top_ = top;
+            listener_.onTopOfBookChange(top_);
+        }
+
+        if (depthFeed_)
+        {
+            publishDepth();
+        }
+    }
+
+    template <typename Listener>
+    void BasicOrderBook<Listener>::publishDepth()
+    {
+        DepthSnapshot snapshot;
+        snapshot.timestamp = messageTime_;
+
+        auto collect = [](const BookSide &side, DepthLevel *levels, std::uint32_t &count)
+        {
+            side.forEachLevel([&](const PriceLevel &level)
+                              {
+                                  levels[count++] = DepthLevel{level.price, level.totalQuantity, level.orderCount};
+                                  return count < DepthSnapshot::kLevels; });
+        };
+        collect(bids_, snapshot.bids, snapshot.bidLevels);
+        collect(asks_, snapshot.asks, snapshot.askLevels);
+
+        depthFeed_->publish(snapshot);
+    }
+
+} // namespace orderbook
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Order.h"
+#include "TopOfBook.h"
+#include "Trade.h"
+
+namespace orderbook
+{
+
+    /**
+     * Default (no-op) hooks for a BasicOrderBook listener.
+     * Derive from this and redeclare only the hooks you need; calls are
+     * resolved statically, so unused hooks compile away and used ones inline
+     * into the matching loop.
+     *
+     * A listener may additionally define
+     *     void onTradeBatch(const Trade *trades, std::size_t count);
+     * to receive all trades of a submitBatch() call in one invocation;
+     * without it, batched trades are delivered through onTrade one by one.
+     * Either way, batched trades are flushed before an overridden
+     * onOrderAccepted or onCancel, so events arrive in causal order.
+     */
+    struct BookListener
+    {
+        // A trade executed between a resting and an incoming order
+        void onTrade(const Trade &) {}
+
+        // An order passed validation; called before it matches. The order is
+        // a transient copy: only a resting remainder is inserted afterwards,
+        // and market, IOC and FOK orders never rest
+        void onOrderAccepted(const Order &) {}
+
+        // A resting order was cancelled and removed from the book, or the
+        // unfilled remainder of a market, IOC or FOK order was dropped
+        void onCancel(const Order &) {}
+
+        // The best bid/offer (price, size or order count) changed; fired at
+        // most once per inbound message, after all of its fills
+        void onTopOfBookChange(const TopOfBook &) {}
+    };
+
+} // namespace orderbook
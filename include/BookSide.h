@@ -0,0 +1,317 @@
+#pragma once
+
+#include "LevelBitmap.h"
+#include "Order.h"
+#include "PriceLevel.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+
+namespace orderbook
+{
+
+    /**
+     * Storage backend for the price levels of one side of the book
+     */
+    enum class LevelStorage
+    {
+        Map,   // Ordered tree; unbounded price range
+        Ladder // Contiguous array indexed by tick offset; for instruments with a known price band
+    };
+
+    /**
+     * The resting price levels of one side of the book.
+     * Levels are kept either in a std::map or in a direct-indexed ladder whose
+     * slot is (price - base) in ticks. The ladder tracks the best level by
+     * index, finds the next occupied slot through a hierarchical occupancy
+     * bitmap, and re-centres its window when a price falls outside it. Level
+     * addresses are stable between re-centres; re-centring relinks the
+     * orders' level back-pointers.
+     */
+    class BookSide
+    {
+    public:
+        using PriceLevelMap = std::map<Price, PriceLevel>;
+
+        static constexpr std::size_t kDefaultLadderTicks = 4096;
+        static constexpr std::size_t kDefaultMaxLadderTicks = std::size_t(1) << 20;
+
+        BookSide(OrderSide side, LevelStorage storage, std::size_t ladderTicks = kDefaultLadderTicks,
+                 std::size_t maxLadderTicks = kDefaultMaxLadderTicks);
+
+        // Orders point at levels owned by this side, so it is move-only
+        BookSide(const BookSide &) = delete;
+        BookSide &operator=(const BookSide &) = delete;
+        BookSide(BookSide &&other) noexcept;
+        BookSide &operator=(BookSide &&other) noexcept;
+
+        ~BookSide() = default;
+
+        bool empty() const
+        {
+            return levelCount() == 0;
+        }
+
+        std::size_t levelCount() const
+        {
+            return storage_ == LevelStorage::Map ? map_.size() : ladderLevels_;
+        }
+
+        LevelStorage storage() const
+        {
+            return storage_;
+        }
+
+        /**
+         * Get the best (most aggressive) level
+         * @return Highest bid / lowest ask, or nullptr if the side is empty
+         */
+        PriceLevel *best()
+        {
+            if (empty())
+            {
+                return nullptr;
+            }
+            if (storage_ == LevelStorage::Ladder)
+            {
+                return &ladder_[bestIndex_];
+            }
+            return side_ == OrderSide::BUY ? &map_.rbegin()->second : &map_.begin()->second;
+        }
+
+        const PriceLevel *best() const
+        {
+            return const_cast<BookSide *>(this)->best();
+        }
+
+        /**
+         * Find the level at a price
+         * @return The level, or nullptr if no orders rest at that price
+         */
+        PriceLevel *find(Price price)
+        {
+            if (storage_ == LevelStorage::Ladder)
+            {
+                if (!inWindow(price))
+                {
+                    return nullptr;
+                }
+                PriceLevel &level = ladder_[slotOf(price)];
+                return level.empty() ? nullptr : &level;
+            }
+
+            auto it = map_.find(price);
+            return it == map_.end() ? nullptr : &it->second;
+        }
+
+        const PriceLevel *find(Price price) const
+        {
+            return const_cast<BookSide *>(this)->find(price);
+        }
+
+        /**
+         * Check that levels at every price in [low, high] could be created.
+         * The map backend holds any price; the ladder only while the span of
+         * occupied levels plus the new prices fits its window cap.
+         */
+        bool canHold(Price low, Price high) const
+        {
+            if (storage_ == LevelStorage::Map || (inWindow(low) && inWindow(high)))
+            {
+                return true;
+            }
+            if (ladderLevels_ > 0)
+            {
+                low = std::min(low, ladder_[occupied_.findNext(0)].price);
+                high = std::max(high, ladder_[occupied_.findPrev(ladderTicks_ - 1)].price);
+            }
+            return spanOf(low, high) <= maxLadderTicks_;
+        }
+
+        bool canHold(Price price) const
+        {
+            return canHold(price, price);
+        }
+
+        /**
+         * Find the level at a price, creating it if needed.
+         * On the ladder the price must pass canHold(); otherwise
+         * std::length_error is thrown and the side is unchanged.
+         * The caller must append at least one order to a newly created level.
+         * @return The level for the price
+         */
+        PriceLevel &findOrCreate(Price price)
+        {
+            if (storage_ == LevelStorage::Map)
+            {
+                return map_.try_emplace(price, price).first->second;
+            }
+
+            if (!inWindow(price))
+            {
+                recenter(price);
+            }
+
+            std::size_t slot = slotOf(price);
+            PriceLevel &level = ladder_[slot];
+            if (level.empty())
+            {
+                level.price = price;
+                occupied_.set(slot);
+                if (ladderLevels_++ == 0 || isBetter(slot, bestIndex_))
+                {
+                    bestIndex_ = slot;
+                }
+            }
+            return level;
+        }
+
+        /**
+         * Create a level behind every existing one, for building a side in
+         * best-to-worst order. On the map backend this is an amortised O(1)
+         * hinted insert at the far end of the tree.
+         * The caller must append at least one order to the new level.
+         * @param price A price strictly worse than every level on this side
+         * @return The new level
+         */
+        PriceLevel &appendWorst(Price price)
+        {
+            if (storage_ == LevelStorage::Map)
+            {
+                // Bids iterate from rbegin, so the worst bid sits at begin()
+                auto hint = side_ == OrderSide::BUY ? map_.begin() : map_.end();
+                return map_.try_emplace(hint, price, price)->second;
+            }
+            return findOrCreate(price);
+        }
+
+        /**
+         * Drop a level whose queue has become empty
+         * @param level A level of this side with no orders left
+         */
+        void erase(PriceLevel &level)
+        {
+            if (storage_ == LevelStorage::Map)
+            {
+                map_.erase(level.price);
+                return;
+            }
+
+            std::size_t slot = static_cast<std::size_t>(&level - ladder_.get());
+            occupied_.clear(slot);
+            --ladderLevels_;
+            if (ladderLevels_ > 0 && slot == bestIndex_)
+            {
+                bestIndex_ = nextOccupied(slot);
+            }
+        }
+
+        /**
+         * Visit non-empty levels from best to worst
+         * @param visit Callable taking (const PriceLevel &); return false to stop
+         */
+        template <typename Visitor>
+        void forEachLevel(Visitor &&visit) const
+        {
+            if (storage_ == LevelStorage::Map)
+            {
+                if (side_ == OrderSide::BUY)
+                {
+                    for (auto it = map_.rbegin(); it != map_.rend(); ++it)
+                    {
+                        if (!visit(it->second))
+                        {
+                            return;
+                        }
+                    }
+                }
+                else
+                {
+                    for (auto it = map_.begin(); it != map_.end(); ++it)
+                    {
+                        if (!visit(it->second))
+                        {
+                            return;
+                        }
+                    }
+                }
+                return;
+            }
+
+            if (ladderLevels_ == 0)
+            {
+                return;
+            }
+            for (std::size_t slot = bestIndex_;;)
+            {
+                if (!visit(static_cast<const PriceLevel &>(ladder_[slot])))
+                {
+                    return;
+                }
+                slot = side_ == OrderSide::BUY ? (slot == 0 ? LevelBitmap::npos : occupied_.findPrev(slot - 1))
+                                               : occupied_.findNext(slot + 1);
+                if (slot == LevelBitmap::npos)
+                {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * Drop every level; the orders themselves are owned elsewhere
+         */
+        void clear();
+
+    private:
+        bool inWindow(Price price) const
+        {
+            return ladder_ && price >= ladderBase_ &&
+                   static_cast<std::size_t>(price - ladderBase_) < ladderTicks_;
+        }
+
+        // Number of ticks in [low, high], saturating rather than overflowing
+        static std::uint64_t spanOf(Price low, Price high)
+        {
+            const std::uint64_t distance = static_cast<std::uint64_t>(high) - static_cast<std::uint64_t>(low);
+            return distance == std::numeric_limits<std::uint64_t>::max() ? distance : distance + 1;
+        }
+
+        std::size_t slotOf(Price price) const
+        {
+            return static_cast<std::size_t>(price - ladderBase_);
+        }
+
+        bool isBetter(std::size_t slot, std::size_t than) const
+        {
+            return side_ == OrderSide::BUY ? slot > than : slot < than;
+        }
+
+        // Next occupied slot behind `slot`; the side must have a level there
+        std::size_t nextOccupied(std::size_t slot) const
+        {
+            return side_ == OrderSide::BUY ? occupied_.findPrev(slot - 1) : occupied_.findNext(slot + 1);
+        }
+
+        // Move the ladder window (growing it if required) so that it covers `price`
+        void recenter(Price price);
+
+        OrderSide side_;
+        LevelStorage storage_;
+
+        // Map backend
+        PriceLevelMap map_;
+
+        // Ladder backend
+        std::unique_ptr<PriceLevel[]> ladder_;
+        std::size_t ladderTicks_;
+        std::size_t maxLadderTicks_; // The window never grows beyond this
+        Price ladderBase_ = 0;
+        std::size_t bestIndex_ = 0;
+        std::size_t ladderLevels_ = 0;
+        LevelBitmap occupied_; // One bit per non-empty ladder slot
+    };
+
+} // namespace orderbook
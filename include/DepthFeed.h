@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Order.h"
+#include "Seqlock.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace orderbook
+{
+
+    /**
+     * Aggregate of one price level; prices are in ticks
+     */
+    struct DepthLevel
+    {
+        Price price = 0;
+        std::uint64_t quantity = 0;
+        std::uint32_t orders = 0;
+    };
+
+    /**
+     * The best levels of both sides as of one inbound message (or batch)
+     */
+    struct DepthSnapshot
+    {
+        static constexpr std::size_t kLevels = 10;
+
+        std::uint64_t timestamp = 0; // Engine time of the message that produced it (ns)
+        std::uint32_t bidLevels = 0; // Valid entries in bids, best first
+        std::uint32_t askLevels = 0; // Valid entries in asks, best first
+        DepthLevel bids[kLevels];
+        DepthLevel asks[kLevels];
+
+        bool hasBid() const
+        {
+            return bidLevels != 0;
+        }
+
+        bool hasAsk() const
+        {
+            return askLevels != 0;
+        }
+    };
+
+    /**
+     * Top-N depth published by the matching thread for any number of reader
+     * threads. The book writes a fresh DepthSnapshot after every message;
+     * readers copy it out of a seqlock, so they never lock, never write a
+     * shared cache line and never hold up the matching thread. A book
+     * publishes to a feed passed in BookOptions; the feed must outlive it.
+     */
+    class DepthFeed
+    {
+    public:
+        /**
+         * Replace the published snapshot (the book's matching thread)
+         */
+        void publish(const DepthSnapshot &snapshot)
+        {
+            snapshot_.store(snapshot);
+        }
+
+        /**
+         * Copy the latest snapshot, retrying while a publish overlaps (any thread)
+         */
+        DepthSnapshot read() const
+        {
+            return snapshot_.load();
+        }
+
+        /**
+         * Try once to copy the latest snapshot (any thread); never waits
+         * @return false if a publish overlapped the copy
+         */
+        bool tryRead(DepthSnapshot &snapshot) const
+        {
+            return snapshot_.tryLoad(snapshot);
+        }
+
+        /**
+         * Number of snapshots published so far; readers can poll it to skip
+         * copies when nothing changed
+         */
+        std::uint64_t version() const
+        {
+            return snapshot_.version();
+        }
+
+    private:
+        Seqlock<DepthSnapshot> snapshot_;
+    };
+
+} // namespace orderbook
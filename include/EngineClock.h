@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ORDERBOOK_HAS_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define ORDERBOOK_HAS_TSC 1
+#else
+#define ORDERBOOK_HAS_TSC 0
+#endif
+
+namespace orderbook
+{
+
+    /**
+     * Where the engine takes its timestamps from
+     */
+    enum class ClockSource
+    {
+        Tsc,    // Calibrated time-stamp counter; falls back to System without an invariant TSC
+        System, // std::chrono::system_clock
+        Replay  // Logical time set from the input stream; never reads a hardware clock
+    };
+
+    /**
+     * Nanosecond wall-clock time source for the engine.
+     * The book reads it once per inbound message and stamps that value on the
+     * order and on every trade the message produces. The TSC source converts
+     * the raw counter with a rate measured against system_clock once per
+     * process, so a read costs an rdtsc and a multiply instead of a clock call.
+     * The Replay source returns whatever time was last set, so replaying
+     * recorded input reproduces its timestamps exactly and runs as fast as
+     * the engine can go.
+     */
+    class EngineClock
+    {
+    public:
+        explicit EngineClock(ClockSource source = ClockSource::Tsc);
+
+        /**
+         * Current time in nanoseconds since the Unix epoch
+         */
+        std::uint64_t now() const
+        {
+#if ORDERBOOK_HAS_TSC
+            if (source_ == ClockSource::Tsc)
+            {
+                const std::uint64_t elapsed = __rdtsc() - tscBase_;
+                return nanosBase_ + static_cast<std::uint64_t>(static_cast<double>(elapsed) * nanosPerTick_);
+            }
+#endif
+            if (source_ == ClockSource::Replay)
+            {
+                return replayTime_;
+            }
+            return systemNow();
+        }
+
+        /**
+         * Set the logical time returned by now() (Replay only; ignored otherwise)
+         * @param nanos Time in nanoseconds since the Unix epoch, taken from the input
+         */
+        void set(std::uint64_t nanos)
+        {
+            replayTime_ = nanos;
+        }
+
+        /**
+         * The source actually in use; Tsc requested on a machine without an
+         * invariant TSC reports System
+         */
+        ClockSource source() const
+        {
+            return source_;
+        }
+
+        static std::uint64_t systemNow()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+    private:
+        ClockSource source_;
+        std::uint64_t tscBase_ = 0;
+        std::uint64_t nanosBase_ = 0;
+        double nanosPerTick_ = 1.0;
+        std::uint64_t replayTime_ = 0;
+    };
+
+} // namespace orderbook
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "Journal.h"
+#include "OrderRequest.h"
+#include "SpscRing.h"
+#include "ThreadAffinity.h"
+#include "WaitStrategy.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace orderbook
+{
+
+    /**
+     * A command on its way into the engine thread
+     */
+    struct EngineCommand
+    {
+        OrderRequest request;
+        std::uint64_t clientTag = 0; // Opaque to the engine; echoed in the ack
+    };
+
+    /**
+     * The engine's answer to one command
+     */
+    struct EngineAck
+    {
+        std::uint64_t clientTag;
+        std::uint64_t orderId;
+        OrderResult result;
+    };
+
+    inline OrderResult &ackResult(EngineAck &ack)
+    {
+        return ack.result;
+    }
+
+    /**
+     * Acks waiting for their journal records to become durable, owned by one
+     * engine thread. Each ack is tagged with the journal and the sequence its
+     * batch must reach; the thread keeps matching and releases acks, in
+     * order, as durableSequence() catches up. If a journal fails first, the
+     * commands it recorded (accepted or killed) are released as
+     * JournalFailed. Ack types expose their result through ackResult().
+     * Held acks live in a ring allocated up front, so holding never
+     * allocates on the matching thread; when it is full, push() waits for
+     * the oldest group to commit before taking more.
+     */
+    template <typename Ack>
+    class JournaledAcks
+    {
+    public:
+        /**
+         * @param capacity Acks that can be held at once (rounded up to a power of two)
+         */
+        explicit JournaledAcks(std::size_t capacity)
+            : capacity_(roundUp(capacity)), mask_(capacity_ - 1), held_(new Held[capacity_])
+        {
+        }
+
+        JournaledAcks(const JournaledAcks &) = delete;
+        JournaledAcks &operator=(const JournaledAcks &) = delete;
+
+        /**
+         * Publish an ack now if nothing is held and its journal allows it,
+         * otherwise hold it behind the acks already waiting
+         * @param journal Journal the ack's batch went to (nullptr: none)
+         * @param sequence Journal sequence after the batch
+         */
+        template <typename Publish>
+        void push(JournalWriter *journal, std::uint64_t sequence, const Ack &ack, Publish &&publish)
+        {
+            if (empty() && (!journal || journal->durableSequence() >= sequence))
+            {
+                publish(ack);
+                return;
+            }
+            // Backpressure only: matching has run a full ring ahead of the journal
+            while (tail_ - head_ == capacity_)
+            {
+                release(publish);
+                if (tail_ - head_ == capacity_)
+                {
+                    cpuRelax();
+                }
+            }
+            held_[tail_++ & mask_] = Held{journal, sequence, ack};
+        }
+
+        /**
+         * Publish every held ack whose records are now durable (or failed),
+         * stopping at the first that must keep waiting
+         */
+        template <typename Publish>
+        void release(Publish &&publish)
+        {
+            while (!empty())
+            {
+                Held &front = held_[head_ & mask_];
+                if (front.journal && front.journal->durableSequence() < front.sequence)
+                {
+                    if (!front.journal->failed())
+                    {
+                        return;
+                    }
+                    // The group may have landed just before the failure
+                    if (front.journal->durableSequence() < front.sequence)
+                    {
+                        OrderResult &result = ackResult(front.ack);
+                        if (result == OrderResult::Accepted || result == OrderResult::Killed)
+                        {
+                            result = OrderResult::JournalFailed;
+                        }
+                    }
+                }
+                publish(front.ack);
+                ++head_;
+            }
+        }
+
+        bool empty() const
+        {
+            return head_ == tail_;
+        }
+
+    private:
+        struct Held
+        {
+            JournalWriter *journal;
+            std::uint64_t sequence;
+            Ack ack;
+        };
+
+        static std::size_t roundUp(std::size_t capacity)
+        {
+            std::size_t rounded = 2;
+            while (rounded < capacity)
+            {
+                rounded <<= 1;
+            }
+            return rounded;
+        }
+
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        const std::unique_ptr<Held[]> held_;
+        std::size_t head_ = 0; // Oldest held ack
+        std::size_t tail_ = 0; // One past the newest
+    };
+
+    struct EngineThreadOptions
+    {
+        std::size_t ingressCapacity = 65536; // Commands queued towards the engine
+        std::size_t egressCapacity = 65536;  // Acks queued back to the client side
+        std::size_t maxBatch = 256;          // Most commands applied per submitBatch call
+        WaitStrategy wait = WaitStrategy::BusySpin;
+        int cpu = -1; // Pin the engine thread to this CPU (negative: unpinned)
+    };
+
+    /**
+     * Runs one book on a dedicated thread, the only thread that ever touches
+     * it. Producers enqueue commands into a lock-free ingress ring (SpscRing
+     * for a single gateway thread, MpscRing for several); the engine drains
+     * whatever has queued, applies it with one submitBatch call, and pushes
+     * one ack per command, in order, into an SPSC egress ring read by a
+     * single client thread. Listener hooks run on the engine thread. With a
+     * journal attached to the book, a batch's acks are held until its
+     * records are durable; matching carries on with later batches meanwhile.
+     *
+     * The book must not be used by any other thread between start() and
+     * stop().
+     */
+    template <typename Book, typename IngressRing = SpscRing<EngineCommand>>
+    class EngineThread
+    {
+    public:
+        explicit EngineThread(Book &book, const EngineThreadOptions &options = EngineThreadOptions())
+            : book_(book), options_(options), ingress_(options.ingressCapacity), egress_(options.egressCapacity),
+              waiter_(options.wait)
+        {
+            if (options_.maxBatch == 0)
+            {
+                options_.maxBatch = 1;
+            }
+        }
+
+        ~EngineThread()
+        {
+            stop();
+        }
+
+        EngineThread(const EngineThread &) = delete;
+        EngineThread &operator=(const EngineThread &) = delete;
+
+        void start()
+        {
+            if (thread_.joinable())
+            {
+                return;
+            }
+            stopping_.store(false, std::memory_order_relaxed);
+            thread_ = std::thread([this]
+                                  { run(); });
+        }
+
+        /**
+         * Apply every command already submitted, then stop the thread.
+         * Producers must have stopped submitting.
+         */
+        void stop()
+        {
+            if (!thread_.joinable())
+            {
+                return;
+            }
+            stopping_.store(true, std::memory_order_release);
+            waiter_.notify();
+            thread_.join();
+        }
+
+        /**
+         * Enqueue a command without waiting
+         * @return false if the ingress ring is full
+         */
+        bool trySubmit(const EngineCommand &command)
+        {
+            if (!ingress_.tryPush(command))
+            {
+                return false;
+            }
+            waiter_.notify();
+            return true;
+        }
+
+        /**
+         * Enqueue a command, spinning while the ingress ring is full
+         */
+        void submit(const EngineCommand &command)
+        {
+            while (!ingress_.tryPush(command))
+            {
+                cpuRelax();
+            }
+            waiter_.notify();
+        }
+
+        /**
+         * Take the next ack, if any (single ack-consumer thread)
+         */
+        bool pollAck(EngineAck &ack)
+        {
+            return egress_.tryPop(ack);
+        }
+
+        /**
+         * Take up to maxCount acks (single ack-consumer thread)
+         */
+        std::size_t pollAcks(EngineAck *acks, std::size_t maxCount)
+        {
+            return egress_.popBatch(acks, maxCount);
+        }
+
+    private:
+        void run()
+        {
+            pinCurrentThread(options_.cpu);
+
+            std::vector<EngineCommand> commands(options_.maxBatch);
+            std::vector<OrderRequest> requests(options_.maxBatch);
+            std::vector<OrderResult> results(options_.maxBatch);
+
+            JournaledAcks<EngineAck> heldAcks(options_.ingressCapacity);
+            auto publish = [this](const EngineAck &ack)
+            {
+                // Backpressure only: the client is a full ring behind
+                while (!egress_.tryPush(ack))
+                {
+                    cpuRelax();
+                }
+            };
+
+            for (;;)
+            {
+                heldAcks.release(publish);
+
+                const std::size_t count = ingress_.popBatch(commands.data(), commands.size());
+                if (count == 0)
+                {
+                    const bool stopping = stopping_.load(std::memory_order_acquire);
+                    if (stopping && ingress_.empty() && heldAcks.empty())
+                    {
+                        break;
+                    }
+                    if (!heldAcks.empty())
+                    {
+                        // A group commit is in flight: poll for it rather than sleep past it
+                        std::this_thread::yield();
+                    }
+                    else if (!stopping)
+                    {
+                        waiter_.idle([this]
+                                     { return !ingress_.empty() || stopping_.load(std::memory_order_acquire); });
+                    }
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    requests[i] = commands[i].request;
+                }
+                book_.submitBatch(requests.data(), count, results.data());
+
+                JournalWriter *journal = book_.journal();
+                const std::uint64_t sequence = book_.journalSequence();
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    heldAcks.push(journal, sequence, EngineAck{commands[i].clientTag, commands[i].request.orderId, results[i]},
+                                  publish);
+                }
+            }
+        }
+
+        Book &book_;
+        EngineThreadOptions options_;
+        IngressRing ingress_;
+        SpscRing<EngineAck> egress_;
+        IdleWaiter waiter_;
+        std::atomic<bool> stopping_{false};
+        std::thread thread_;
+    };
+
+} // namespace orderbook
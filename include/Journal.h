@@ -0,0 +1,170 @@
+#pragma once
+
+#include "OrderRequest.h"
+#include "SpscRing.h"
+#include "WaitStrategy.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace orderbook
+{
+
+    /**
+     * One accepted command as stored in the journal file.
+     * Fixed 56-byte layout in host byte order; the file starts with a
+     * JournalHeader followed by back-to-back records. The header's byteOrder
+     * marker lets a reader on a host of the other endianness reject the file.
+     */
+    struct JournalRecord
+    {
+        std::uint64_t sequence;   // 1-based position in the journal
+        std::uint64_t timestamp;  // Engine time of the command (ns)
+        std::uint64_t orderId;
+        double price;
+        std::uint64_t quantity;
+        std::uint64_t peakQuantity; // Iceberg display size (0: not an iceberg)
+        std::uint8_t type;        // RequestType
+        std::uint8_t side;        // OrderSide
+        std::uint8_t orderType;   // OrderType
+        std::uint8_t timeInForce; // TimeInForce
+        std::uint8_t reserved[4];
+    };
+
+    static_assert(sizeof(JournalRecord) == 56, "JournalRecord is an on-disk format");
+    static_assert(std::is_trivially_copyable<JournalRecord>::value, "JournalRecord is written with memcpy semantics");
+
+    struct JournalHeader
+    {
+        char magic[8];            // "OBJRNL\0\0"
+        std::uint32_t version;    // kJournalVersion
+        std::uint32_t recordSize; // sizeof(JournalRecord)
+        std::uint32_t byteOrder;  // kJournalByteOrder as written by the host
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(JournalHeader) == 24, "JournalHeader is an on-disk format");
+
+    inline constexpr std::uint32_t kJournalVersion = 3;
+    inline constexpr std::uint32_t kJournalByteOrder = 0x01020304; // Reads as 0x04030201 on a foreign-endian host
+
+    struct JournalOptions
+    {
+        std::string path;                  // Journal file; appended to if it already exists
+        std::size_t queueCapacity = 65536; // Commands in flight between the engine and the writer
+        std::size_t maxBatch = 4096;       // Most commands written and synced as one group
+        bool sync = true;                  // fdatasync after each group; off only for tests/benchmarks
+        WaitStrategy wait = WaitStrategy::Block; // How the writer thread waits for commands
+    };
+
+    /**
+     * Append-only binary write-ahead journal with group commit.
+     * The matching thread hands each accepted command to append(), which only
+     * copies it into a lock-free SPSC ring. A dedicated writer thread drains
+     * whatever has queued, writes it with one write() and makes it durable
+     * with one fdatasync(), then publishes the highest durable sequence.
+     * While a sync is in flight new commands keep queuing and go out together
+     * in the next group, so the per-command cost of durability falls as load
+     * rises. A command may be acknowledged once durableSequence() has reached
+     * the sequence append() returned for it.
+     *
+     * One producer thread per JournalWriter: append() may move to another
+     * thread only through a hand-over that orders it after the previous
+     * producer's last call (as MatchingEngine::moveSymbol does), never run
+     * concurrently from two.
+     *
+     * Uses open/write/fdatasync on POSIX and the MSVCRT _open/_write/_commit
+     * equivalents on Windows.
+     */
+    class JournalWriter
+    {
+    public:
+        explicit JournalWriter(const JournalOptions &options);
+        ~JournalWriter();
+
+        JournalWriter(const JournalWriter &) = delete;
+        JournalWriter &operator=(const JournalWriter &) = delete;
+
+        /**
+         * Queue one accepted command (single producer: the matching thread).
+         * Never touches the file; if the ring is full it spins until the
+         * writer frees a slot.
+         * @param request The command as applied by the book
+         * @return The command's journal sequence
+         */
+        std::uint64_t append(const OrderRequest &request);
+
+        /**
+         * Highest sequence whose record (and every earlier one) is on disk
+         */
+        std::uint64_t durableSequence() const
+        {
+            return durable_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Highest sequence handed to append()
+         */
+        std::uint64_t appendedSequence() const
+        {
+            return nextSequence_ - 1;
+        }
+
+        /**
+         * Wait until sequence is durable
+         * @return false if the writer hit an I/O error first
+         */
+        bool waitDurable(std::uint64_t sequence) const;
+
+        /**
+         * Number of write+sync groups issued so far
+         */
+        std::uint64_t groupCommits() const
+        {
+            return groupCommits_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * True once a write or sync has failed; nothing after the failure is durable
+         */
+        bool failed() const
+        {
+            return failed_.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Flush everything queued, stop the writer thread and close the file
+         */
+        void close();
+
+    private:
+        void run();
+        bool writeAll(const void *data, std::size_t size);
+
+        JournalOptions options_;
+        int fd_ = -1;
+        std::uint64_t nextSequence_ = 1;
+        SpscRing<JournalRecord> ring_;
+
+        alignas(kCacheLineSize) std::atomic<std::uint64_t> durable_{0};
+        std::atomic<std::uint64_t> groupCommits_{0};
+        std::atomic<bool> failed_{false};
+        std::atomic<bool> stopping_{false};
+        IdleWaiter waiter_;
+        std::thread writer_;
+    };
+
+    /**
+     * Read every complete record of a journal file back as commands, in
+     * order, with their recorded timestamps. A torn record at the end (from a
+     * crash mid-write) is ignored. Feed the result to submitBatch() on a book
+     * using ClockSource::Replay to rebuild the state.
+     * @throws std::runtime_error if the file cannot be read or has a bad header
+     */
+    std::vector<OrderRequest> readJournal(const std::string &path);
+
+} // namespace orderbook
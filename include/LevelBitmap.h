@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace orderbook
+{
+
+    namespace detail
+    {
+        // Index of the lowest set bit; `word` must be non-zero. Compiles to tzcnt with BMI enabled.
+        inline unsigned lowestBit(std::uint64_t word)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+        }
+
+        // Index of the highest set bit; `word` must be non-zero. Compiles to lzcnt with LZCNT enabled.
+        inline unsigned highestBit(std::uint64_t word)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanReverse64(&index, word);
+            return static_cast<unsigned>(index);
+#else
+            return 63u - static_cast<unsigned>(__builtin_clzll(word));
+#endif
+        }
+    } // namespace detail
+
+    /**
+     * Hierarchical occupancy bitmap over price ladder slots.
+     * Layer 0 holds one bit per slot; every higher layer holds one bit per
+     * non-zero word of the layer below. Finding the nearest occupied slot in
+     * either direction touches at most one word per layer; ⌈log64(slots)⌉
+     * layers, four at the default 2^20-tick ladder cap, independent of how
+     * many empty slots lie in between.
+     */
+    class LevelBitmap
+    {
+    public:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        LevelBitmap() = default;
+
+        explicit LevelBitmap(std::size_t bits)
+        {
+            resize(bits);
+        }
+
+        /**
+         * Resize to `bits` slots and clear every bit
+         * @param bits Number of slots to track
+         */
+        void resize(std::size_t bits)
+        {
+            layers_.clear();
+            do
+            {
+                std::size_t words = (bits + 63) / 64;
+                layers_.emplace_back(words, 0);
+                bits = words;
+            } while (bits > 1);
+        }
+
+        void reset()
+        {
+            for (auto &layer : layers_)
+            {
+                std::fill(layer.begin(), layer.end(), 0);
+            }
+        }
+
+        bool test(std::size_t index) const
+        {
+            return (layers_[0][index >> 6] >> (index & 63)) & 1u;
+        }
+
+        void set(std::size_t index)
+        {
+            for (auto &layer : layers_)
+            {
+                std::uint64_t &word = layer[index >> 6];
+                bool wasEmpty = word == 0;
+                word |= std::uint64_t{1} << (index & 63);
+                if (!wasEmpty)
+                {
+                    break; // Upper layers already mark this word
+                }
+                index >>= 6;
+            }
+        }
+
+        void clear(std::size_t index)
+        {
+            for (auto &layer : layers_)
+            {
+                std::uint64_t &word = layer[index >> 6];
+                word &= ~(std::uint64_t{1} << (index & 63));
+                if (word != 0)
+                {
+                    break; // Word still occupied; upper layers unchanged
+                }
+                index >>= 6;
+            }
+        }
+
+        /**
+         * Find the lowest set slot at or above `index`
+         * @return The slot, or npos if there is none
+         */
+        std::size_t findNext(std::size_t index) const
+        {
+            std::size_t layer = 0;
+            for (;;)
+            {
+                const auto &words = layers_[layer];
+                std::size_t word = index >> 6;
+                if (word >= words.size())
+                {
+                    return npos;
+                }
+
+                std::uint64_t bits = words[word] & (~std::uint64_t{0} << (index & 63));
+                if (bits != 0)
+                {
+                    index = (word << 6) | detail::lowestBit(bits);
+                    break;
+                }
+
+                if (++layer == layers_.size())
+                {
+                    return npos;
+                }
+                index = word + 1;
+            }
+
+            // Descend to the lowest occupied slot under the word found
+            while (layer-- > 0)
+            {
+                index = (index << 6) | detail::lowestBit(layers_[layer][index]);
+            }
+            return index;
+        }
+
+        /**
+         * Find the highest set slot at or below `index`
+         * @return The slot, or npos if there is none
+         */
+        std::size_t findPrev(std::size_t index) const
+        {
+            std::size_t layer = 0;
+            for (;;)
+            {
+                const auto &words = layers_[layer];
+                std::size_t word = index >> 6;
+                std::uint64_t bits = words[word] & (~std::uint64_t{0} >> (63 - (index & 63)));
+                if (bits != 0)
+                {
+                    index = (word << 6) | detail::highestBit(bits);
+                    break;
+                }
+
+                if (word == 0 || ++layer == layers_.size())
+                {
+                    return npos;
+                }
+                index = word - 1;
+            }
+
+            // Descend to the highest occupied slot under the word found
+            while (layer-- > 0)
+            {
+                index = (index << 6) | detail::highestBit(layers_[layer][index]);
+            }
+            return index;
+        }
+
+    private:
+        std::vector<std::vector<std::uint64_t>> layers_;
+    };
+
+} // namespace orderbook
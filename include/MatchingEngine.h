@@ -0,0 +1,238 @@
+#pragma once
+
+#include "EngineThread.h"
+#include "MpscRing.h"
+#include "OrderBook.h"
+#include "SpscRing.h"
+#include "WaitStrategy.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace orderbook
+{
+
+    using SymbolId = std::uint32_t;
+
+    /**
+     * An ack from one shard, tagged with the symbol it concerns
+     */
+    struct SymbolAck
+    {
+        SymbolId symbol;
+        EngineAck ack;
+    };
+
+    inline OrderResult &ackResult(SymbolAck &ack)
+    {
+        return ack.ack.result;
+    }
+
+    /**
+     * Engine-wide settings. Per-symbol settings, including the journal, go in
+     * the BookOptions given to addSymbol(); a JournalWriter takes one
+     * producer thread, so every journaled symbol needs its own.
+     */
+    struct MatchingEngineOptions
+    {
+        std::size_t shards = 1;              // Worker threads
+        std::vector<int> cpus;               // CPU per shard (missing or negative: unpinned)
+        std::size_t ingressCapacity = 65536; // Per-shard command ring
+        std::size_t egressCapacity = 65536;  // Per-shard ack ring
+        std::size_t maxBatch = 256;          // Most commands drained per ring read
+        bool acks = true;                    // Publish a SymbolAck per command; without acks nothing waits for the journal
+        WaitStrategy wait = WaitStrategy::BusySpin;
+    };
+
+    /**
+     * Many instruments, one OrderBook each, partitioned across worker threads.
+     *
+     * Symbols are registered before start(); the directory is then fixed, so
+     * submit() resolves a SymbolId with a plain array index. Each symbol is
+     * owned by exactly one shard at a time, and only that shard's thread
+     * touches its book. Commands go into the owning shard's MPSC ring, so any
+     * number of gateway threads can submit without locks; per-symbol order is
+     * the order in which submit() calls for that symbol completed.
+     *
+     * moveSymbol() hands a book to another shard without stopping: routing is
+     * paused for that symbol only while in-flight submits drain, a release
+     * marker is queued behind its pending commands on the old shard, and the
+     * new shard parks any commands that reach it first until the old one
+     * passes the book over. rebalance() uses the per-symbol command counts to
+     * move hot symbols off the busiest shard.
+     *
+     * Each shard acks its commands in order. Acks for a symbol that moved
+     * may interleave between its old and new shard; match them by clientTag.
+     * Each journaled symbol needs a journal of its own, since symbols on
+     * different shards would otherwise append to it concurrently; a moved
+     * symbol's journal is handed over with its book. A
+     * symbol's acks wait for its journal, if it has one, to make them durable;
+     * the shard holds them and keeps matching meanwhile. The acks are the only
+     * outcome gated on the journal: with acks off, listener callbacks are all
+     * a client sees, and they fire before the records are durable.
+     */
+    class MatchingEngine
+    {
+    public:
+        explicit MatchingEngine(const MatchingEngineOptions &options = MatchingEngineOptions());
+        ~MatchingEngine();
+
+        MatchingEngine(const MatchingEngine &) = delete;
+        MatchingEngine &operator=(const MatchingEngine &) = delete;
+
+        /**
+         * Register an instrument (before start() only)
+         * @param name Unique symbol name
+         * @param options Options for its book
+         * @param shard Initial shard; defaults to round-robin
+         * @return The symbol's id
+         * @throws std::invalid_argument on a duplicate name, a journal already
+         *         given to another symbol, or after start()
+         */
+        SymbolId addSymbol(const std::string &name, const BookOptions &options = BookOptions(), int shard = -1);
+
+        /**
+         * Look up a symbol id by name
+         * @return true and sets id if the symbol exists
+         */
+        bool findSymbol(const std::string &name, SymbolId &id) const;
+
+        /**
+         * Access a symbol's book. Safe only before start() (e.g. to attach
+         * callbacks, which then run on the owning shard thread) or after stop().
+         */
+        OrderBook &book(SymbolId symbol);
+
+        std::size_t symbolCount() const
+        {
+            return symbols_.size();
+        }
+
+        std::size_t shardCount() const
+        {
+            return shards_.size();
+        }
+
+        void start();
+
+        /**
+         * Apply every command already submitted, then stop all shards.
+         * Producers must have stopped submitting.
+         */
+        void stop();
+
+        /**
+         * Route a command to the shard that owns the symbol (any thread)
+         */
+        void submit(SymbolId symbol, const EngineCommand &command);
+
+        /**
+         * Collect acks from all shards (single ack-consumer thread)
+         * @return Number of acks written to out
+         */
+        std::size_t pollAcks(SymbolAck *out, std::size_t maxCount);
+
+        /**
+         * Shard currently owning a symbol
+         */
+        std::size_t shardOf(SymbolId symbol) const;
+
+        /**
+         * Move a symbol to another shard while the engine runs (control
+         * thread; calls are serialised)
+         */
+        void moveSymbol(SymbolId symbol, std::size_t shard);
+
+        /**
+         * Move hot symbols from the busiest shards to the idlest, based on
+         * commands processed since the previous call (control thread)
+         * @param maxMoves Upper bound on symbols moved by this call
+         * @return Number of symbols moved
+         */
+        std::size_t rebalance(std::size_t maxMoves = 8);
+
+        /**
+         * Commands applied so far, summed over all shards
+         */
+        std::uint64_t processedCommands() const;
+
+    private:
+        enum class ShardCommandKind : std::uint32_t
+        {
+            Order,
+            Release // Old owner: stop owning the symbol and hand it to `target`
+        };
+
+        struct ShardCommand
+        {
+            EngineCommand command;
+            SymbolId symbol;
+            ShardCommandKind kind;
+            std::uint32_t target;
+        };
+
+        struct alignas(kCacheLineSize) Symbol
+        {
+            static constexpr std::uint32_t kMigrating = 0x80000000u;
+
+            Symbol(std::string symbolName, const BookOptions &options, std::uint32_t shard)
+                : name(std::move(symbolName)), book(options), route(shard), owner(shard) {}
+
+            std::string name;
+            OrderBook book;
+
+            // Routing, read by every producer
+            alignas(kCacheLineSize) std::atomic<std::uint32_t> route; // Owning shard, or'd with kMigrating during a move
+            std::atomic<std::uint32_t> writers{0};                    // Submits between route read and ring push
+
+            // Owned by the shard threads
+            alignas(kCacheLineSize) std::atomic<std::uint32_t> owner; // Set on adoption, kMigrating after Release
+            std::atomic<std::uint64_t> processed{0};                  // Commands applied (written by the owner only)
+            std::uint64_t processedAtLastRebalance = 0;               // Control thread only
+        };
+
+        struct alignas(kCacheLineSize) Shard
+        {
+            Shard(const MatchingEngineOptions &options)
+                : ingress(options.ingressCapacity), egress(options.egressCapacity), waiter(options.wait),
+                  heldAcks(options.ingressCapacity) {}
+
+            MpscRing<ShardCommand> ingress;
+            SpscRing<SymbolAck> egress;
+            IdleWaiter waiter;
+            std::atomic<std::uint64_t> processed{0};
+
+            // Symbols released to this shard, pushed by their old owner. Sized
+            // for every symbol (created by start()), so it is never full: a
+            // symbol cannot move again before its adoption, and a shard never
+            // waits on another shard's ring
+            std::unique_ptr<MpscRing<SymbolId>> adoptions;
+            std::unordered_map<SymbolId, std::vector<EngineCommand>> parked; // Arrived before the adoption
+            JournaledAcks<SymbolAck> heldAcks;                                // Waiting for journal records
+            std::thread thread;
+        };
+
+        void run(std::size_t shardIndex);
+        void adopt(std::size_t shardIndex, SymbolId symbol, OrderRequest *requests, OrderResult *results);
+        void apply(Shard &shard, SymbolId symbol, const EngineCommand *commands, std::size_t count,
+                   OrderRequest *requests, OrderResult *results);
+        void push(std::size_t shardIndex, const ShardCommand &command);
+        static void publish(Shard &shard, const SymbolAck &ack);
+
+        MatchingEngineOptions options_;
+        std::vector<std::unique_ptr<Symbol>> symbols_;
+        std::unordered_map<std::string, SymbolId> names_;
+        std::vector<std::unique_ptr<Shard>> shards_;
+        std::size_t nextAckShard_ = 0;
+        std::atomic<bool> stopping_{false};
+        bool started_ = false;
+        std::mutex controlMutex_;
+    };
+
+} // namespace orderbook
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "SpscRing.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace orderbook
+{
+
+    /**
+     * Bounded lock-free multi-producer/single-consumer ring buffer.
+     * Each slot carries a sequence number that says whose turn it is: a
+     * producer claims a position with one CAS on the enqueue index and then
+     * publishes the slot by advancing its sequence, so producers never wait
+     * on each other's copies and the consumer never writes a shared index.
+     * Same interface as SpscRing.
+     */
+    template <typename T>
+    class MpscRing
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "MpscRing slots are copied with plain stores");
+
+    public:
+        explicit MpscRing(std::size_t capacity)
+            : capacity_(roundUp(capacity)), mask_(capacity_ - 1), cells_(new Cell[capacity_])
+        {
+            for (std::size_t i = 0; i < capacity_; ++i)
+            {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscRing(const MpscRing &) = delete;
+        MpscRing &operator=(const MpscRing &) = delete;
+
+        /**
+         * Append one element (any thread)
+         * @return false if the ring is full
+         */
+        bool tryPush(const T &value)
+        {
+            std::size_t position = enqueue_.load(std::memory_order_relaxed);
+            Cell *cell;
+            for (;;)
+            {
+                cell = &cells_[position & mask_];
+                const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence - position);
+                if (lag == 0)
+                {
+                    if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (lag < 0)
+                {
+                    return false; // The consumer has not freed this slot yet
+                }
+                else
+                {
+                    position = enqueue_.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = value;
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Remove one element (consumer thread only)
+         * @return false if the ring is empty
+         */
+        bool tryPop(T &value)
+        {
+            return popBatch(&value, 1) == 1;
+        }
+
+        /**
+         * Remove up to maxCount elements (consumer thread only). Stops at the
+         * first slot whose producer has not finished publishing.
+         * @return Number of elements removed
+         */
+        std::size_t popBatch(T *out, std::size_t maxCount)
+        {
+            std::size_t count = 0;
+            while (count < maxCount)
+            {
+                Cell &cell = cells_[dequeue_ & mask_];
+                if (cell.sequence.load(std::memory_order_acquire) != dequeue_ + 1)
+                {
+                    break;
+                }
+                out[count++] = cell.value;
+                cell.sequence.store(dequeue_ + capacity_, std::memory_order_release);
+                ++dequeue_;
+            }
+            return count;
+        }
+
+        /**
+         * True if the next slot is not yet published (consumer thread only)
+         */
+        bool empty() const
+        {
+            return cells_[dequeue_ & mask_].sequence.load(std::memory_order_acquire) != dequeue_ + 1;
+        }
+
+        std::size_t capacity() const
+        {
+            return capacity_;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        static std::size_t roundUp(std::size_t capacity)
+        {
+            std::size_t rounded = 2;
+            while (rounded < capacity)
+            {
+                rounded <<= 1;
+            }
+            return rounded;
+        }
+
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        const std::unique_ptr<Cell[]> cells_;
+
+        // Shared by producers
+        alignas(kCacheLineSize) std::atomic<std::size_t> enqueue_{0};
+
+        // Consumer only
+        alignas(kCacheLineSize) std::size_t dequeue_ = 0;
+
+        char padding_[kCacheLineSize - sizeof(std::size_t)];
+    };
+
+} // namespace orderbook
@@ -1,31 +1,71 @@
 #pragma once
 
+#include "EngineClock.h"
 #include <cstdint>
 #include <string>
-#include <chrono>
 
 namespace orderbook
 {
 
+    /**
+     * Fixed-point price expressed as an integer number of ticks.
+     * Conversion to and from decimal prices happens only at the OrderBook API
+     * edge, using the tick size configured on each book.
+     */
+    using Price = std::int64_t;
+
+    struct PriceLevel;
+
     enum class OrderSide
     {
         BUY,
         SELL
     };
 
+    enum class OrderType : std::uint8_t
+    {
+        Limit, // Trades at the limit price or better
+        Market // Trades at any price; never rests
+    };
+
+    /**
+     * How long the unfilled part of an order may stay in the book
+     */
+    enum class TimeInForce : std::uint8_t
+    {
+        GoodTillCancel,    // Rests until filled or cancelled
+        ImmediateOrCancel, // Fills what it can on arrival; the rest is cancelled
+        FillOrKill         // Fills completely on arrival or not at all
+    };
+
     struct Order
     {
         std::uint64_t orderId;
         OrderSide side;
-        double price;
+        double price;       // Limit price as submitted
         std::uint64_t quantity;
-        std::uint64_t timestamp;
+        std::uint64_t timestamp; // Nanoseconds since the Unix epoch; the book stamps its own arrival time
+        Price priceTicks;   // Limit price in ticks, assigned by the book on entry
+        std::uint64_t sequence; // Engine arrival sequence, assigned by the book; defines time priority
+
+        // Iceberg reserve: quantity is the displayed peak; when it fills, the
+        // next peak is taken from hiddenQuantity and joins the back of the queue
+        std::uint64_t hiddenQuantity;
+        std::uint64_t peakQuantity; // Display size (0: not an iceberg)
+
+        // Intrusive links into the resting price level, owned by the book
+        Order *prev;
+        Order *next;
+        PriceLevel *level;
 
         Order(std::uint64_t id, OrderSide s, double p, std::uint64_t qty)
-            : orderId(id), side(s), price(p), quantity(qty),
-              timestamp(std::chrono::duration_cast<std::chrono::microseconds>(
-                            std::chrono::high_resolution_clock::now().time_since_epoch())
-                            .count()) {}
+            : Order(id, s, p, qty, EngineClock::systemNow()) {}
+
+        // Construct with an arrival time supplied by the engine (no clock read)
+        Order(std::uint64_t id, OrderSide s, double p, std::uint64_t qty, std::uint64_t ts)
+            : orderId(id), side(s), price(p), quantity(qty), timestamp(ts),
+              priceTicks(0), sequence(0), hiddenQuantity(0), peakQuantity(0), prev(nullptr), next(nullptr),
+              level(nullptr) {}
 
         // Copy constructor
         Order(const Order &other) = default;
@@ -45,22 +85,33 @@ namespace orderbook
         {
             if (side == OrderSide::BUY)
             {
-                // For bids: higher price first, then earlier timestamp
+                // For bids: higher price first, then earlier arrival
                 if (price != other.price)
                 {
                     return price > other.price;
                 }
-                return timestamp < other.timestamp;
+                return arrivedBefore(other);
             }
             else
             {
-                // For asks: lower price first, then earlier timestamp
+                // For asks: lower price first, then earlier arrival
                 if (price != other.price)
                 {
                     return price < other.price;
                 }
-                return timestamp < other.timestamp;
+                return arrivedBefore(other);
+            }
+        }
+
+        // Time priority: engine sequence once both orders are in a book,
+        // creation timestamp otherwise
+        bool arrivedBefore(const Order &other) const
+        {
+            if (sequence != 0 && other.sequence != 0)
+            {
+                return sequence < other.sequence;
             }
+            return timestamp < other.timestamp;
         }
 
         bool operator>(const Order &other) const
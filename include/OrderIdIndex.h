@@ -0,0 +1,298 @@
+#pragma once
+
+#include "Order.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace orderbook
+{
+
+    /**
+     * Open-addressing id -> order index using Robin Hood linear probing.
+     * Slots are stored inline in one flat array (key + pointer, 16 bytes), so a
+     * lookup is usually a single cache line. Probe sequences stay short
+     * because entries far from their home slot displace entries close to
+     * theirs, and lookups stop as soon as they pass the point where the key
+     * would have been placed. Erase shifts the following cluster back by one
+     * slot instead of leaving tombstones, so heavy cancel traffic never
+     * degrades probe lengths or forces a rehash. A moved-from index holds no
+     * table until its next insert.
+     */
+    class OrderIdIndex
+    {
+    public:
+        explicit OrderIdIndex(std::size_t expected = 0)
+        {
+            rehash(capacityFor(expected));
+        }
+
+        OrderIdIndex(const OrderIdIndex &) = delete;
+        OrderIdIndex &operator=(const OrderIdIndex &) = delete;
+
+        OrderIdIndex(OrderIdIndex &&other) noexcept
+            : slots_(std::move(other.slots_)),
+              mask_(other.mask_),
+              shift_(other.shift_),
+              size_(std::exchange(other.size_, 0)),
+              maxSize_(std::exchange(other.maxSize_, 0))
+        {
+            other.mask_ = 0;
+            other.shift_ = 64;
+        }
+
+        OrderIdIndex &operator=(OrderIdIndex &&other) noexcept
+        {
+            if (this != &other)
+            {
+                slots_ = std::move(other.slots_);
+                mask_ = other.mask_;
+                shift_ = other.shift_;
+                size_ = std::exchange(other.size_, 0);
+                maxSize_ = std::exchange(other.maxSize_, 0);
+                other.mask_ = 0;
+                other.shift_ = 64;
+            }
+            return *this;
+        }
+
+        ~OrderIdIndex() = default;
+
+        /**
+         * Look up an order by id
+         * @return The order, or nullptr if the id is not present
+         */
+        Order *find(std::uint64_t orderId) const
+        {
+            if (size_ == 0)
+            {
+                return nullptr;
+            }
+            std::size_t slot = home(orderId);
+            for (std::size_t distance = 0;; ++distance, slot = (slot + 1) & mask_)
+            {
+                const Slot &entry = slots_[slot];
+                if (!entry.order || probeDistance(entry.orderId, slot) < distance)
+                {
+                    return nullptr;
+                }
+                if (entry.orderId == orderId)
+                {
+                    return entry.order;
+                }
+            }
+        }
+
+        /**
+         * Hint that `orderId` is about to be inserted or looked up, so its home
+         * slot is pulled into cache while the caller does other work. Bulk
+         * loaders issue this a few records ahead to overlap table misses.
+         */
+        void prefetch(std::uint64_t orderId) const
+        {
+            if (slots_.empty())
+            {
+                return;
+            }
+#if defined(_MSC_VER)
+            _mm_prefetch(reinterpret_cast<const char *>(&slots_[home(orderId)]), _MM_HINT_T0);
+#else
+            __builtin_prefetch(&slots_[home(orderId)], 1);
+#endif
+        }
+
+        /**
+         * Insert an id -> order mapping
+         * @return false if the id is already present
+         */
+        bool insert(std::uint64_t orderId, Order *order)
+        {
+            if (size_ >= maxSize_)
+            {
+                rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+            }
+
+            Slot incoming{orderId, order};
+            bool displaced = false;
+            std::size_t slot = home(orderId);
+            for (std::size_t distance = 0;; ++distance, slot = (slot + 1) & mask_)
+            {
+                Slot &entry = slots_[slot];
+                if (!entry.order)
+                {
+                    entry = incoming;
+                    ++size_;
+                    return true;
+                }
+
+                // The Robin Hood invariant places a duplicate before any richer slot
+                if (!displaced && entry.orderId == orderId)
+                {
+                    return false;
+                }
+
+                std::size_t existing = probeDistance(entry.orderId, slot);
+                if (existing < distance)
+                {
+                    std::swap(incoming, entry);
+                    distance = existing;
+                    displaced = true;
+                }
+            }
+        }
+
+        /**
+         * Remove an id
+         * @return false if the id was not present
+         */
+        bool erase(std::uint64_t orderId)
+        {
+            if (size_ == 0)
+            {
+                return false;
+            }
+            std::size_t slot = home(orderId);
+            for (std::size_t distance = 0;; ++distance, slot = (slot + 1) & mask_)
+            {
+                const Slot &entry = slots_[slot];
+                if (!entry.order || probeDistance(entry.orderId, slot) < distance)
+                {
+                    return false;
+                }
+                if (entry.orderId == orderId)
+                {
+                    break;
+                }
+            }
+
+            // Backward-shift deletion: pull the rest of the cluster one slot closer to home
+            std::size_t next = (slot + 1) & mask_;
+            while (slots_[next].order && probeDistance(slots_[next].orderId, next) > 0)
+            {
+                slots_[slot] = slots_[next];
+                slot = next;
+                next = (next + 1) & mask_;
+            }
+            slots_[slot].order = nullptr;
+            --size_;
+            return true;
+        }
+
+        /**
+         * Pre-size so that `count` ids fit without rehashing
+         */
+        void reserve(std::size_t count)
+        {
+            std::size_t capacity = capacityFor(count);
+            if (capacity > slots_.size())
+            {
+                rehash(capacity);
+            }
+        }
+
+        /**
+         * Visit every stored order
+         * @param visit Callable taking (Order *)
+         */
+        template <typename Visitor>
+        void forEach(Visitor &&visit) const
+        {
+            for (const Slot &entry : slots_)
+            {
+                if (entry.order)
+                {
+                    visit(entry.order);
+                }
+            }
+        }
+
+        void clear()
+        {
+            for (Slot &entry : slots_)
+            {
+                entry.order = nullptr;
+            }
+            size_ = 0;
+        }
+
+        std::size_t size() const
+        {
+            return size_;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        std::size_t capacity() const
+        {
+            return slots_.size();
+        }
+
+    private:
+        struct Slot
+        {
+            std::uint64_t orderId;
+            Order *order; // nullptr marks an empty slot
+        };
+
+        static constexpr std::size_t kMinCapacity = 16;
+
+        // Maximum load factor of 7/8
+        static std::size_t capacityFor(std::size_t count)
+        {
+            std::size_t capacity = kMinCapacity;
+            while (capacity - capacity / 8 <= count)
+            {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        // Fibonacci hashing spreads sequential ids across the table
+        std::size_t home(std::uint64_t orderId) const
+        {
+            return static_cast<std::size_t>((orderId * 0x9E3779B97F4A7C15ull) >> shift_);
+        }
+
+        std::size_t probeDistance(std::uint64_t orderId, std::size_t slot) const
+        {
+            return (slot - home(orderId)) & mask_;
+        }
+
+        void rehash(std::size_t capacity)
+        {
+            std::vector<Slot> old = std::move(slots_);
+            slots_.assign(capacity, Slot{0, nullptr});
+            mask_ = capacity - 1;
+            shift_ = 64;
+            for (std::size_t bits = capacity; bits > 1; bits >>= 1)
+            {
+                --shift_;
+            }
+            size_ = 0;
+            maxSize_ = capacity - capacity / 8;
+
+            for (const Slot &entry : old)
+            {
+                if (entry.order)
+                {
+                    insert(entry.orderId, entry.order);
+                }
+            }
+        }
+
+        std::vector<Slot> slots_;
+        std::size_t mask_ = 0;
+        unsigned shift_ = 64;
+        std::size_t size_ = 0;
+        std::size_t maxSize_ = 0;
+    };
+
+} // namespace orderbook
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Order.h"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace orderbook
+{
+
+    /**
+     * Slab allocator for Order objects owned by the engine.
+     * Orders are constructed in fixed-size slabs that are never moved or freed
+     * while the pool lives, so raw Order pointers are stable handles. Released
+     * slots go onto an intrusive free list and are reused LIFO (cache-warm),
+     * so once the pool has grown to the working set no further heap
+     * allocation happens.
+     */
+    class OrderPool
+    {
+    public:
+        static constexpr std::size_t kDefaultSlabSize = 4096;
+
+        explicit OrderPool(std::size_t slabSize = kDefaultSlabSize)
+            : slabSize_(slabSize > 0 ? slabSize : 1) {}
+
+        // Handles point into the slabs, so the pool is move-only
+        OrderPool(const OrderPool &) = delete;
+        OrderPool &operator=(const OrderPool &) = delete;
+        OrderPool(OrderPool &&other) noexcept
+            : slabs_(std::move(other.slabs_)),
+              freeList_(std::exchange(other.freeList_, nullptr)),
+              slabSize_(other.slabSize_),
+              inUse_(std::exchange(other.inUse_, 0))
+        {
+        }
+
+        OrderPool &operator=(OrderPool &&other) noexcept
+        {
+            if (this != &other)
+            {
+                slabs_ = std::move(other.slabs_);
+                freeList_ = std::exchange(other.freeList_, nullptr);
+                slabSize_ = other.slabSize_;
+                inUse_ = std::exchange(other.inUse_, 0);
+            }
+            return *this;
+        }
+
+        ~OrderPool() = default;
+
+        /**
+         * Construct an order in a free slot, growing by one slab if needed
+         * @return Stable pointer to the new order
+         */
+        template <typename... Args>
+        Order *create(Args &&...args)
+        {
+            if (!freeList_)
+            {
+                addSlab();
+            }
+
+            Slot *slot = freeList_;
+            freeList_ = slot->nextFree;
+            ++inUse_;
+            return new (slot->storage) Order(std::forward<Args>(args)...);
+        }
+
+        /**
+         * Return an order's slot to the free list
+         * @param order Pointer previously obtained from create()
+         */
+        void destroy(Order *order)
+        {
+            order->~Order();
+            Slot *slot = reinterpret_cast<Slot *>(order);
+            slot->nextFree = freeList_;
+            freeList_ = slot;
+            --inUse_;
+        }
+
+        /**
+         * Pre-allocate slabs so that at least `count` orders fit without growing
+         * @param count Number of orders to reserve room for
+         */
+        void reserve(std::size_t count)
+        {
+            while (capacity() < count)
+            {
+                addSlab();
+            }
+        }
+
+        std::size_t capacity() const
+        {
+            return slabs_.size() * slabSize_;
+        }
+
+        std::size_t inUse() const
+        {
+            return inUse_;
+        }
+
+    private:
+        // Slots are reused without running destructors of the previous occupant
+        static_assert(std::is_trivially_destructible<Order>::value,
+                      "OrderPool requires a trivially destructible Order");
+
+        union Slot
+        {
+            Slot *nextFree;
+            alignas(Order) unsigned char storage[sizeof(Order)];
+        };
+
+        void addSlab()
+        {
+            std::unique_ptr<Slot[]> slab(new Slot[slabSize_]);
+
+            // Thread the new slots onto the free list in address order
+            for (std::size_t i = slabSize_; i-- > 0;)
+            {
+                slab[i].nextFree = freeList_;
+                freeList_ = &slab[i];
+            }
+            slabs_.push_back(std::move(slab));
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> slabs_;
+        Slot *freeList_ = nullptr;
+        std::size_t slabSize_;
+        std::size_t inUse_ = 0;
+    };
+
+} // namespace orderbook
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Order.h"
+#include <cstdint>
+
+namespace orderbook
+{
+
+    /**
+     * Outcome of a single order entry command
+     */
+    enum class OrderResult : std::uint8_t
+    {
+        Accepted,        // Command applied
+        InvalidQuantity, // Add or modify with zero quantity
+        InvalidPrice,    // Limit price not finite or not on the book's tick grid
+        PriceOutOfRange, // Resting price beyond the ladder window cap (LevelStorage::Ladder)
+        DuplicateId,     // Add whose id is already resting
+        UnknownOrder,    // Cancel/modify of an id that is not resting
+        Killed,          // Fill-or-kill that could not fill completely; nothing traded
+        JournalFailed    // Applied, but its journal record could not be made durable (engine acks only)
+    };
+
+    enum class RequestType : std::uint8_t
+    {
+        Add,
+        Cancel,
+        Modify,
+        Clear // Remove every resting order
+    };
+
+    /**
+     * One command in a submitBatch() call.
+     * Cancel uses only orderId; Modify uses orderId, price and quantity;
+     * Clear uses none of the fields.
+     * orderType, timeInForce and peakQuantity apply to Add only; a market
+     * order ignores price. A non-zero peakQuantity below quantity makes a
+     * resting remainder an iceberg that displays at most that much.
+     * timestamp is the command's recorded time, used only by a book running
+     * on ClockSource::Replay.
+     */
+    struct OrderRequest
+    {
+        RequestType type = RequestType::Add;
+        OrderSide side = OrderSide::BUY;
+        std::uint64_t orderId = 0;
+        double price = 0.0;
+        std::uint64_t quantity = 0;
+        std::uint64_t timestamp = 0;
+        OrderType orderType = OrderType::Limit;
+        TimeInForce timeInForce = TimeInForce::GoodTillCancel;
+        std::uint64_t peakQuantity = 0;
+    };
+
+} // namespace orderbook
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Order.h"
+
+namespace orderbook
+{
+
+    /**
+     * FIFO queue of resting orders at a single price.
+     * Orders are linked intrusively through Order::prev/next and point back to
+     * their level, so appending, cancelling and removing fills are all O(1)
+     * regardless of queue depth. The level also keeps the running total
+     * quantity and order count so depth can be read without walking the queue.
+     */
+    struct PriceLevel
+    {
+        Price price;
+        Order *head = nullptr; // Oldest order (first to match)
+        Order *tail = nullptr; // Newest order
+        std::uint64_t totalQuantity = 0;
+        std::uint32_t orderCount = 0;
+
+        explicit PriceLevel(Price p = 0) : price(p) {}
+
+        // Levels are referenced by their orders, so they must not move
+        PriceLevel(const PriceLevel &) = delete;
+        PriceLevel &operator=(const PriceLevel &) = delete;
+
+        bool empty() const
+        {
+            return head == nullptr;
+        }
+
+        Order *front() const
+        {
+            return head;
+        }
+
+        /**
+         * Append an order at the back of the queue
+         * @param order The order to link; must not belong to any level
+         */
+        void pushBack(Order *order)
+        {
+            order->prev = tail;
+            order->next = nullptr;
+            order->level = this;
+
+            if (tail)
+            {
+                tail->next = order;
+            }
+            else
+            {
+                head = order;
+            }
+            tail = order;
+
+            totalQuantity += order->quantity;
+            ++orderCount;
+        }
+
+        /**
+         * Unlink an order from anywhere in the queue
+         * @param order The order to unlink; must belong to this level
+         */
+        void remove(Order *order)
+        {
+            if (order->prev)
+            {
+                order->prev->next = order->next;
+            }
+            else
+            {
+                head = order->next;
+            }
+
+            if (order->next)
+            {
+                order->next->prev = order->prev;
+            }
+            else
+            {
+                tail = order->prev;
+            }
+
+            order->prev = nullptr;
+            order->next = nullptr;
+            order->level = nullptr;
+
+            totalQuantity -= order->quantity;
+            --orderCount;
+        }
+
+        /**
+         * Reduce a queued order's quantity in place, keeping its position
+         * @param order The order to reduce; must belong to this level
+         * @param quantity Amount to take off; at most the order's quantity
+         */
+        void reduce(Order *order, std::uint64_t quantity)
+        {
+            order->quantity -= quantity;
+            totalQuantity -= quantity;
+        }
+    };
+
+} // namespace orderbook
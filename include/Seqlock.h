@@ -0,0 +1,114 @@
+#pragma once
+
+#include "SpscRing.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace orderbook
+{
+
+    /**
+     * Single-writer sequence lock around a trivially copyable value.
+     * The writer bumps the sequence to odd, stores the value and bumps it to
+     * even again; it never waits for readers. A reader copies the value
+     * between two reads of the sequence and keeps the copy only if both are
+     * the same even number, so any number of readers get consistent views
+     * without writing to shared memory. The value is held as relaxed atomic
+     * words, which keeps the concurrent copy free of data races.
+     */
+    template <typename T>
+    class Seqlock
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Seqlock values are copied word by word");
+
+    public:
+        Seqlock()
+        {
+            std::uint64_t buffer[kWords] = {};
+            const T initial{};
+            std::memcpy(buffer, &initial, sizeof(T));
+            for (std::size_t i = 0; i < kWords; ++i)
+            {
+                words_[i].store(buffer[i], std::memory_order_relaxed);
+            }
+        }
+
+        Seqlock(const Seqlock &) = delete;
+        Seqlock &operator=(const Seqlock &) = delete;
+
+        /**
+         * Publish a new value (single writer thread)
+         */
+        void store(const T &value)
+        {
+            std::uint64_t buffer[kWords] = {};
+            std::memcpy(buffer, &value, sizeof(T));
+
+            const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (std::size_t i = 0; i < kWords; ++i)
+            {
+                words_[i].store(buffer[i], std::memory_order_relaxed);
+            }
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+         * Copy the value once (any thread); never waits
+         * @return false if a store overlapped the copy; out is then unspecified
+         */
+        bool tryLoad(T &out) const
+        {
+            const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                return false;
+            }
+
+            std::uint64_t buffer[kWords];
+            for (std::size_t i = 0; i < kWords; ++i)
+            {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) != before)
+            {
+                return false;
+            }
+
+            std::memcpy(&out, buffer, sizeof(T));
+            return true;
+        }
+
+        /**
+         * Copy a consistent value (any thread), retrying while stores overlap
+         */
+        T load() const
+        {
+            T value;
+            while (!tryLoad(value))
+            {
+            }
+            return value;
+        }
+
+        /**
+         * Number of completed stores
+         */
+        std::uint64_t version() const
+        {
+            return sequence_.load(std::memory_order_acquire) / 2;
+        }
+
+    private:
+        static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        alignas(kCacheLineSize) std::atomic<std::uint64_t> sequence_{0};
+        std::atomic<std::uint64_t> words_[kWords];
+    };
+
+} // namespace orderbook
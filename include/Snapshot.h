@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Order.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace orderbook
+{
+
+    /**
+     * Snapshot file header.
+     * The header is followed by bidOrders records for the bid side, then
+     * askOrders records for the ask side. Each side runs from best to worst
+     * level, with orders in queue order within a level, so a level is a
+     * contiguous run of records sharing priceTicks. Fixed layout in host
+     * byte order, suitable for mmap; the byteOrder marker lets a loader on a
+     * host of the other endianness reject the file.
+     */
+    struct SnapshotHeader
+    {
+        char magic[8];                 // "OBSNAP\0\0"
+        std::uint32_t version;         // kSnapshotVersion
+        std::uint32_t recordSize;      // sizeof(SnapshotRecord)
+        std::uint32_t byteOrder;       // kSnapshotByteOrder as written by the host
+        std::uint32_t reserved;
+        double tickSize;               // Tick size of the book that wrote it
+        std::uint64_t nextSequence;    // Engine arrival sequence to continue from
+        std::uint64_t journalSequence; // Last journal record reflected in the snapshot (0 without a journal)
+        std::uint64_t bidOrders;
+        std::uint64_t askOrders;
+    };
+
+    struct SnapshotRecord
+    {
+        std::uint64_t orderId;
+        Price priceTicks;
+        std::uint64_t quantity; // Displayed quantity
+        std::uint64_t timestamp;
+        std::uint64_t sequence;
+        double price; // Limit price as submitted
+        std::uint64_t hiddenQuantity; // Iceberg reserve
+        std::uint64_t peakQuantity;   // Iceberg display size (0: not an iceberg)
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader is an on-disk format");
+    static_assert(sizeof(SnapshotRecord) == 64, "SnapshotRecord is an on-disk format");
+    static_assert(std::is_trivially_copyable<SnapshotRecord>::value, "SnapshotRecord is read straight from the mapping");
+
+    inline constexpr std::uint32_t kSnapshotVersion = 3;
+    inline constexpr std::uint32_t kSnapshotByteOrder = 0x01020304; // Reads as 0x04030201 on a foreign-endian host
+
+    /**
+     * Streams a snapshot to disk through a fixed buffer. The file is written
+     * under a temporary name, synced, and renamed into place by finish(),
+     * which then syncs the directory; a crash never leaves a truncated
+     * snapshot at the target path, and a finished one survives it.
+     */
+    class SnapshotWriter
+    {
+    public:
+        /**
+         * @throws std::runtime_error if the file cannot be created
+         */
+        SnapshotWriter(const std::string &path, SnapshotHeader header);
+
+        void append(const SnapshotRecord &record)
+        {
+            buffer_.push_back(record);
+            if (buffer_.size() == kBufferRecords)
+            {
+                flush();
+            }
+        }
+
+        /**
+         * Write out buffered records, sync the file and move it into place
+         * @throws std::runtime_error on I/O failure
+         */
+        void finish();
+
+    private:
+        static constexpr std::size_t kBufferRecords = 8192;
+
+        void flush();
+
+        std::string path_;
+        std::string tempPath_;
+        std::ofstream out_;
+        std::vector<SnapshotRecord> buffer_;
+    };
+
+    /**
+     * Read-only memory mapping of a snapshot file with a validated header.
+     * Uses mmap on POSIX; on Windows the file is read into memory instead.
+     */
+    class MappedSnapshot
+    {
+    public:
+        /**
+         * @throws std::runtime_error if the file cannot be mapped, has a bad
+         * header (including one written in the other byte order), or its size does not match the header's record counts
+         */
+        explicit MappedSnapshot(const std::string &path);
+        ~MappedSnapshot();
+
+        MappedSnapshot(const MappedSnapshot &) = delete;
+        MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+
+        const SnapshotHeader &header() const
+        {
+            return *static_cast<const SnapshotHeader *>(data_);
+        }
+
+        // Bid records followed by ask records
+        const SnapshotRecord *records() const
+        {
+            return reinterpret_cast<const SnapshotRecord *>(static_cast<const char *>(data_) + sizeof(SnapshotHeader));
+        }
+
+    private:
+        void *data_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    SnapshotHeader makeSnapshotHeader();
+
+} // namespace orderbook
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace orderbook
+{
+
+    // Keeps producer- and consumer-owned fields on separate cache lines
+    inline constexpr std::size_t kCacheLineSize = 64;
+
+    /**
+     * Bounded lock-free single-producer/single-consumer ring buffer.
+     * Capacity is rounded up to a power of two so slots are found with a mask.
+     * The producer and consumer each keep a cached copy of the other side's
+     * index and only reload the shared atomic when the cache says the ring is
+     * full (or empty), so in steady state a push or pop touches no cache line
+     * owned by the other thread.
+     */
+    template <typename T>
+    class SpscRing
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SpscRing slots are copied with plain stores");
+
+    public:
+        explicit SpscRing(std::size_t capacity)
+            : capacity_(roundUp(capacity)), mask_(capacity_ - 1), slots_(new T[capacity_])
+        {
+        }
+
+        SpscRing(const SpscRing &) = delete;
+        SpscRing &operator=(const SpscRing &) = delete;
+
+        /**
+         * Append one element (producer thread only)
+         * @return false if the ring is full
+         */
+        bool tryPush(const T &value)
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - headCache_ == capacity_)
+            {
+                headCache_ = head_.load(std::memory_order_acquire);
+                if (tail - headCache_ == capacity_)
+                {
+                    return false;
+                }
+            }
+
+            slots_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Remove one element (consumer thread only)
+         * @return false if the ring is empty
+         */
+        bool tryPop(T &value)
+        {
+            return popBatch(&value, 1) == 1;
+        }
+
+        /**
+         * Remove up to maxCount elements in one step (consumer thread only)
+         * @param out Destination for the elements, in FIFO order
+         * @param maxCount Capacity of out
+         * @return Number of elements removed
+         */
+        std::size_t popBatch(T *out, std::size_t maxCount)
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (tailCache_ == head)
+            {
+                tailCache_ = tail_.load(std::memory_order_acquire);
+                if (tailCache_ == head)
+                {
+                    return 0;
+                }
+            }
+
+            const std::size_t available = tailCache_ - head;
+            const std::size_t count = available < maxCount ? available : maxCount;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i] = slots_[(head + i) & mask_];
+            }
+            head_.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * Approximate number of queued elements (exact when both sides are idle)
+         */
+        std::size_t size() const
+        {
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+        std::size_t capacity() const
+        {
+            return capacity_;
+        }
+
+    private:
+        static std::size_t roundUp(std::size_t capacity)
+        {
+            std::size_t rounded = 2;
+            while (rounded < capacity)
+            {
+                rounded <<= 1;
+            }
+            return rounded;
+        }
+
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        const std::unique_ptr<T[]> slots_;
+
+        // Consumer side
+        alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+        std::size_t tailCache_ = 0;
+
+        // Producer side
+        alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+        std::size_t headCache_ = 0;
+
+        char padding_[kCacheLineSize - sizeof(std::size_t) * 2];
+    };
+
+} // namespace orderbook
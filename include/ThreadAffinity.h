@@ -0,0 +1,33 @@
+#pragma once
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace orderbook
+{
+
+    /**
+     * Pin the calling thread to one CPU
+     * @param cpu CPU index; negative leaves the thread unpinned
+     * @return true if the thread is now pinned (always false off Linux)
+     */
+    inline bool pinCurrentThread(int cpu)
+    {
+#if defined(__linux__)
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+        {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+} // namespace orderbook
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Order.h"
+#include <cstdint>
+
+namespace orderbook
+{
+
+    /**
+     * Best bid and offer with aggregate size at each touch.
+     * Prices are in ticks; a side with no orders has a zero order count.
+     */
+    struct TopOfBook
+    {
+        Price bidPrice = 0;
+        std::uint64_t bidQuantity = 0;
+        std::uint32_t bidOrders = 0;
+
+        Price askPrice = 0;
+        std::uint64_t askQuantity = 0;
+        std::uint32_t askOrders = 0;
+
+        bool hasBid() const
+        {
+            return bidOrders != 0;
+        }
+
+        bool hasAsk() const
+        {
+            return askOrders != 0;
+        }
+
+        bool operator==(const TopOfBook &other) const
+        {
+            return bidPrice == other.bidPrice && bidQuantity == other.bidQuantity && bidOrders == other.bidOrders &&
+                   askPrice == other.askPrice && askQuantity == other.askQuantity && askOrders == other.askOrders;
+        }
+
+        bool operator!=(const TopOfBook &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+} // namespace orderbook
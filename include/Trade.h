@@ -0,0 +1,25 @@
+#pragma once
+
+#include "EngineClock.h"
+#include <cstdint>
+
+namespace orderbook
+{
+
+    struct Trade
+    {
+        std::uint64_t buyOrderId;
+        std::uint64_t sellOrderId;
+        double price;
+        std::uint64_t quantity;
+        std::uint64_t timestamp; // Nanoseconds since the Unix epoch
+
+        Trade(std::uint64_t buyId, std::uint64_t sellId, double p, std::uint64_t qty)
+            : Trade(buyId, sellId, p, qty, EngineClock::systemNow()) {}
+
+        // Construct with the engine's per-message timestamp (no clock read)
+        Trade(std::uint64_t buyId, std::uint64_t sellId, double p, std::uint64_t qty, std::uint64_t ts)
+            : buyOrderId(buyId), sellOrderId(sellId), price(p), quantity(qty), timestamp(ts) {}
+    };
+
+} // namespace orderbook
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace orderbook
+{
+
+    /**
+     * How a consumer thread waits when its ring is empty
+     */
+    enum class WaitStrategy
+    {
+        BusySpin, // Poll continuously; lowest latency, burns a core
+        Yield,    // Poll, yielding the CPU between polls
+        Block     // Spin briefly, then sleep until a producer signals
+    };
+
+    // Spin-loop hint: lets the sibling hyperthread run and avoids the
+    // memory-order pipeline flush when the awaited store lands
+    inline void cpuRelax()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    /**
+     * Idle policy for one consumer plus the wake-up signal its producers
+     * raise. Only the Block strategy ever sleeps; producers call notify()
+     * after every push, which costs one load unless the consumer is asleep.
+     */
+    class IdleWaiter
+    {
+    public:
+        static constexpr int kSpinsBeforeSleep = 2000;
+
+        explicit IdleWaiter(WaitStrategy strategy = WaitStrategy::BusySpin)
+            : strategy_(strategy) {}
+
+        /**
+         * Called by the consumer after finding its ring empty; returns when
+         * it is worth polling again
+         * @param ready Returns true once there is work (or a stop request)
+         */
+        template <typename Ready>
+        void idle(Ready &&ready)
+        {
+            switch (strategy_)
+            {
+            case WaitStrategy::BusySpin:
+                cpuRelax();
+                return;
+            case WaitStrategy::Yield:
+                std::this_thread::yield();
+                return;
+            case WaitStrategy::Block:
+                break;
+            }
+
+            for (int spin = 0; spin < kSpinsBeforeSleep; ++spin)
+            {
+                if (ready())
+                {
+                    return;
+                }
+                cpuRelax();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleeping_.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // The timeout only bounds the damage of a missed signal
+            condition_.wait_for(lock, std::chrono::milliseconds(1), ready);
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * Called by a producer after publishing work
+         */
+        void notify()
+        {
+            if (strategy_ != WaitStrategy::Block)
+            {
+                return;
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping_.load(std::memory_order_seq_cst))
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                condition_.notify_one();
+            }
+        }
+
+        WaitStrategy strategy() const
+        {
+            return strategy_;
+        }
+
+    private:
+        WaitStrategy strategy_;
+        std::atomic<bool> sleeping_{false};
+        std::mutex mutex_;
+        std::condition_variable condition_;
+    };
+
+} // namespace orderbook
@@ -0,0 +1,124 @@
+#include "BookSide.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace orderbook
+{
+
+    BookSide::BookSide(OrderSide side, LevelStorage storage, std::size_t ladderTicks, std::size_t maxLadderTicks)
+        : side_(side), storage_(storage), ladderTicks_(std::max<std::size_t>(ladderTicks, 1)),
+          maxLadderTicks_(std::max(maxLadderTicks, ladderTicks_))
+    {
+    }
+
+    BookSide::BookSide(BookSide &&other) noexcept
+        : side_(other.side_),
+          storage_(other.storage_),
+          map_(std::move(other.map_)),
+          ladder_(std::move(other.ladder_)),
+          ladderTicks_(other.ladderTicks_),
+          maxLadderTicks_(other.maxLadderTicks_),
+          ladderBase_(other.ladderBase_),
+          bestIndex_(other.bestIndex_),
+          ladderLevels_(std::exchange(other.ladderLevels_, 0)),
+          occupied_(std::move(other.occupied_))
+    {
+    }
+
+    BookSide &BookSide::operator=(BookSide &&other) noexcept
+    {
+        if (this != &other)
+        {
+            side_ = other.side_;
+            storage_ = other.storage_;
+            map_ = std::move(other.map_);
+            ladder_ = std::move(other.ladder_);
+            ladderTicks_ = other.ladderTicks_;
+            maxLadderTicks_ = other.maxLadderTicks_;
+            ladderBase_ = other.ladderBase_;
+            bestIndex_ = other.bestIndex_;
+            ladderLevels_ = std::exchange(other.ladderLevels_, 0);
+            occupied_ = std::move(other.occupied_);
+        }
+        return *this;
+    }
+
+    void BookSide::clear()
+    {
+        map_.clear();
+
+        if (ladderLevels_ > 0)
+        {
+            for (std::size_t slot = occupied_.findNext(0); slot != LevelBitmap::npos; slot = occupied_.findNext(slot + 1))
+            {
+                ladder_[slot].head = nullptr;
+                ladder_[slot].tail = nullptr;
+                ladder_[slot].totalQuantity = 0;
+                ladder_[slot].orderCount = 0;
+            }
+            occupied_.reset();
+        }
+        ladderLevels_ = 0;
+    }
+
+    void BookSide::recenter(Price price)
+    {
+        // Occupied price range that must survive the move, plus the new price
+        Price low = price;
+        Price high = price;
+        if (ladderLevels_ > 0)
+        {
+            low = std::min(low, ladder_[occupied_.findNext(0)].price);
+            high = std::max(high, ladder_[occupied_.findPrev(ladderTicks_ - 1)].price);
+        }
+
+        // Keep the window at least twice the occupied span so drift re-centres
+        // rarely, but never beyond the cap; one outlier price must not
+        // allocate an arbitrarily large ladder
+        const std::uint64_t fullSpan = spanOf(low, high);
+        if (fullSpan > maxLadderTicks_)
+        {
+            throw std::length_error("Price is outside the ladder window cap");
+        }
+        const std::size_t span = static_cast<std::size_t>(fullSpan);
+        std::size_t newTicks = ladderTicks_;
+        while (newTicks < span * 2 && newTicks < maxLadderTicks_)
+        {
+            newTicks *= 2;
+        }
+        newTicks = std::max(std::min(newTicks, maxLadderTicks_), span);
+
+        Price newBase = low - static_cast<Price>((newTicks - span) / 2);
+        std::unique_ptr<PriceLevel[]> newLadder(new PriceLevel[newTicks]);
+        LevelBitmap newOccupied(newTicks);
+
+        if (ladderLevels_ > 0)
+        {
+            for (std::size_t slot = occupied_.findNext(0); slot != LevelBitmap::npos; slot = occupied_.findNext(slot + 1))
+            {
+                PriceLevel &from = ladder_[slot];
+                std::size_t newSlot = static_cast<std::size_t>(from.price - newBase);
+                newOccupied.set(newSlot);
+
+                PriceLevel &to = newLadder[newSlot];
+                to.price = from.price;
+                to.head = from.head;
+                to.tail = from.tail;
+                to.totalQuantity = from.totalQuantity;
+                to.orderCount = from.orderCount;
+                for (Order *order = to.head; order; order = order->next)
+                {
+                    order->level = &to;
+                }
+            }
+            bestIndex_ = static_cast<std::size_t>(ladder_[bestIndex_].price - newBase);
+        }
+
+        ladder_ = std::move(newLadder);
+        occupied_ = std::move(newOccupied);
+        ladderTicks_ = newTicks;
+        ladderBase_ = newBase;
+    }
+
+} // namespace orderbook
@@ -0,0 +1,130 @@
+#include "EngineClock.h"
+
+#if ORDERBOOK_HAS_TSC && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace orderbook
+{
+
+    namespace
+    {
+#if ORDERBOOK_HAS_TSC
+        struct TscCalibration
+        {
+            bool usable = false;
+            std::uint64_t tscBase = 0;
+            std::uint64_t nanosBase = 0;
+            double nanosPerTick = 1.0;
+        };
+
+        // CPUID leaf 0x80000007, EDX bit 8: the counter runs at a constant
+        // rate across P/C-states and is usable as a clock
+        bool hasInvariantTsc()
+        {
+#if defined(_MSC_VER)
+            int regs[4] = {};
+            __cpuid(regs, 0x80000000);
+            if (static_cast<unsigned>(regs[0]) < 0x80000007u)
+            {
+                return false;
+            }
+            __cpuid(regs, 0x80000007);
+            return (regs[3] & (1 << 8)) != 0;
+#else
+            unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx))
+            {
+                return false;
+            }
+            return (edx & (1u << 8)) != 0;
+#endif
+        }
+
+        // Read system_clock bracketed by two counter reads, keeping the
+        // tightest of a few tries, and pair it with the bracket's midpoint
+        std::uint64_t sampleSystem(std::uint64_t &tsc)
+        {
+            std::uint64_t nanos = 0;
+            std::uint64_t bestWidth = ~std::uint64_t{0};
+            for (int attempt = 0; attempt < 8; ++attempt)
+            {
+                const std::uint64_t before = __rdtsc();
+                const std::uint64_t now = EngineClock::systemNow();
+                const std::uint64_t after = __rdtsc();
+                if (after >= before && after - before < bestWidth)
+                {
+                    bestWidth = after - before;
+                    nanos = now;
+                    tsc = before + (after - before) / 2;
+                }
+            }
+            return nanos;
+        }
+
+        TscCalibration calibrate()
+        {
+            TscCalibration result;
+            if (!hasInvariantTsc())
+            {
+                return result;
+            }
+
+            // Measure the counter against system_clock over a short spin.
+            // Each end is pinned to within half its bracket (typically
+            // 10-30ns), so over 10ms the rate is good to a few parts per
+            // million, plus whatever slew NTP applies during the window
+            const auto window = std::chrono::milliseconds(10);
+            std::uint64_t startTsc = 0;
+            const std::uint64_t startNanos = sampleSystem(startTsc);
+            std::uint64_t now = startNanos;
+            while (now - startNanos < static_cast<std::uint64_t>(std::chrono::nanoseconds(window).count()))
+            {
+                now = EngineClock::systemNow();
+            }
+            std::uint64_t endTsc = 0;
+            const std::uint64_t endNanos = sampleSystem(endTsc);
+
+            if (endTsc <= startTsc || endNanos <= startNanos)
+            {
+                return result;
+            }
+
+            result.usable = true;
+            result.tscBase = startTsc;
+            result.nanosBase = startNanos;
+            result.nanosPerTick = static_cast<double>(endNanos - startNanos) / static_cast<double>(endTsc - startTsc);
+            return result;
+        }
+
+        // Calibrated once per process so every book shares the same mapping
+        const TscCalibration &tscCalibration()
+        {
+            static const TscCalibration calibration = calibrate();
+            return calibration;
+        }
+#endif
+    } // namespace
+
+    EngineClock::EngineClock(ClockSource source)
+        : source_(source)
+    {
+        if (source_ != ClockSource::Tsc)
+        {
+            return;
+        }
+
+#if ORDERBOOK_HAS_TSC
+        const TscCalibration &calibration = tscCalibration();
+        if (calibration.usable)
+        {
+            tscBase_ = calibration.tscBase;
+            nanosBase_ = calibration.nanosBase;
+            nanosPerTick_ = calibration.nanosPerTick;
+            return;
+        }
+#endif
+        source_ = ClockSource::System;
+    }
+
+} // namespace orderbook
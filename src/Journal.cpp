@@ -0,0 +1,337 @@
+#include "Journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace orderbook
+{
+
+    namespace
+    {
+        constexpr char kJournalMagic[8] = {'O', 'B', 'J', 'R', 'N', 'L', '\0', '\0'};
+
+        JournalHeader makeHeader()
+        {
+            JournalHeader header{};
+            std::memcpy(header.magic, kJournalMagic, sizeof(kJournalMagic));
+            header.version = kJournalVersion;
+            header.recordSize = sizeof(JournalRecord);
+            header.byteOrder = kJournalByteOrder;
+            return header;
+        }
+
+        bool validHeader(const JournalHeader &header)
+        {
+            return std::memcmp(header.magic, kJournalMagic, sizeof(kJournalMagic)) == 0 &&
+                   header.version == kJournalVersion && header.recordSize == sizeof(JournalRecord) &&
+                   header.byteOrder == kJournalByteOrder;
+        }
+
+        // Thin layer over the POSIX calls and their MSVCRT equivalents
+#if defined(_WIN32)
+        int openJournal(const std::string &path)
+        {
+            return ::_open(path.c_str(), _O_RDWR | _O_CREAT | _O_APPEND | _O_BINARY | _O_NOINHERIT,
+                           _S_IREAD | _S_IWRITE);
+        }
+
+        void closeFile(int fd)
+        {
+            ::_close(fd);
+        }
+
+        bool fileSize(int fd, std::uint64_t &size)
+        {
+            struct _stati64 info;
+            if (::_fstati64(fd, &info) != 0)
+            {
+                return false;
+            }
+            size = static_cast<std::uint64_t>(info.st_size);
+            return true;
+        }
+
+        bool readAt(int fd, void *data, std::size_t size, std::uint64_t offset)
+        {
+            // Appends still go to the end: the file is opened with _O_APPEND
+            return ::_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) == static_cast<__int64>(offset) &&
+                   ::_read(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+        }
+
+        long long writeSome(int fd, const void *data, std::size_t size)
+        {
+            return ::_write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+        }
+
+        bool truncateFile(int fd, std::uint64_t size)
+        {
+            return ::_chsize_s(fd, static_cast<__int64>(size)) == 0;
+        }
+
+        int syncData(int fd)
+        {
+            return ::_commit(fd);
+        }
+#else
+        int openJournal(const std::string &path)
+        {
+            return ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        }
+
+        void closeFile(int fd)
+        {
+            ::close(fd);
+        }
+
+        bool fileSize(int fd, std::uint64_t &size)
+        {
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+            {
+                return false;
+            }
+            size = static_cast<std::uint64_t>(info.st_size);
+            return true;
+        }
+
+        bool readAt(int fd, void *data, std::size_t size, std::uint64_t offset)
+        {
+            return ::pread(fd, data, size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size);
+        }
+
+        long long writeSome(int fd, const void *data, std::size_t size)
+        {
+            return ::write(fd, data, size);
+        }
+
+        bool truncateFile(int fd, std::uint64_t size)
+        {
+            return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+        }
+
+        int syncData(int fd)
+        {
+#if defined(__APPLE__)
+            return ::fsync(fd);
+#else
+            return ::fdatasync(fd);
+#endif
+        }
+#endif
+
+        std::runtime_error journalError(const std::string &what, const std::string &path)
+        {
+            return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+        }
+    } // namespace
+
+    JournalWriter::JournalWriter(const JournalOptions &options)
+        : options_(options), ring_(options.queueCapacity), waiter_(options.wait)
+    {
+        options_.maxBatch = std::max<std::size_t>(options_.maxBatch, 1);
+
+        fd_ = openJournal(options_.path);
+        if (fd_ < 0)
+        {
+            throw journalError("Cannot open journal", options_.path);
+        }
+
+        std::uint64_t size = 0;
+        if (!fileSize(fd_, size))
+        {
+            closeFile(fd_);
+            throw journalError("Cannot stat journal", options_.path);
+        }
+
+        if (size == 0)
+        {
+            const JournalHeader header = makeHeader();
+            if (!writeAll(&header, sizeof(header)) || syncData(fd_) != 0)
+            {
+                closeFile(fd_);
+                throw journalError("Cannot initialise journal", options_.path);
+            }
+        }
+        else
+        {
+            // Continue an existing journal after its last complete record
+            JournalHeader header{};
+            if (size < sizeof(header) || !readAt(fd_, &header, sizeof(header), 0) || !validHeader(header))
+            {
+                closeFile(fd_);
+                throw std::runtime_error("Not a journal file: '" + options_.path + "'");
+            }
+
+            const std::uint64_t records = (size - sizeof(header)) / sizeof(JournalRecord);
+            const std::uint64_t complete = sizeof(header) + records * sizeof(JournalRecord);
+            if (complete != size && !truncateFile(fd_, complete))
+            {
+                closeFile(fd_);
+                throw journalError("Cannot truncate torn journal record", options_.path);
+            }
+            nextSequence_ = records + 1;
+            durable_.store(records, std::memory_order_relaxed);
+        }
+
+        writer_ = std::thread([this]
+                              { run(); });
+    }
+
+    JournalWriter::~JournalWriter()
+    {
+        close();
+    }
+
+    std::uint64_t JournalWriter::append(const OrderRequest &request)
+    {
+        JournalRecord record{};
+        record.sequence = nextSequence_++;
+        record.timestamp = request.timestamp;
+        record.orderId = request.orderId;
+        record.price = request.price;
+        record.quantity = request.quantity;
+        record.peakQuantity = request.peakQuantity;
+        record.type = static_cast<std::uint8_t>(request.type);
+        record.side = static_cast<std::uint8_t>(request.side);
+        record.orderType = static_cast<std::uint8_t>(request.orderType);
+        record.timeInForce = static_cast<std::uint8_t>(request.timeInForce);
+
+        // Backpressure only: the writer is behind by a full ring
+        while (!ring_.tryPush(record))
+        {
+            std::this_thread::yield();
+        }
+        waiter_.notify();
+        return record.sequence;
+    }
+
+    bool JournalWriter::waitDurable(std::uint64_t sequence) const
+    {
+        while (durableSequence() < sequence)
+        {
+            if (failed())
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    void JournalWriter::close()
+    {
+        if (writer_.joinable())
+        {
+            stopping_.store(true, std::memory_order_release);
+            waiter_.notify();
+            writer_.join();
+        }
+        if (fd_ >= 0)
+        {
+            closeFile(fd_);
+            fd_ = -1;
+        }
+    }
+
+    void JournalWriter::run()
+    {
+        std::vector<JournalRecord> group(options_.maxBatch);
+
+        for (;;)
+        {
+            const std::size_t count = ring_.popBatch(group.data(), group.size());
+            if (count == 0)
+            {
+                if (stopping_.load(std::memory_order_acquire) && ring_.empty())
+                {
+                    break;
+                }
+                waiter_.idle([this]
+                             { return !ring_.empty() || stopping_.load(std::memory_order_acquire); });
+                continue;
+            }
+
+            // After a failure keep draining so the producer never stalls, but
+            // stop advancing the durable sequence
+            if (failed())
+            {
+                continue;
+            }
+
+            // One write and one sync for the whole group
+            if (!writeAll(group.data(), count * sizeof(JournalRecord)) ||
+                (options_.sync && syncData(fd_) != 0))
+            {
+                failed_.store(true, std::memory_order_release);
+                continue;
+            }
+
+            durable_.store(group[count - 1].sequence, std::memory_order_release);
+            groupCommits_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool JournalWriter::writeAll(const void *data, std::size_t size)
+    {
+        const char *bytes = static_cast<const char *>(data);
+        while (size > 0)
+        {
+            const long long written = writeSome(fd_, bytes, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    std::vector<OrderRequest> readJournal(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw journalError("Cannot open journal", path);
+        }
+
+        JournalHeader header{};
+        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) || !validHeader(header))
+        {
+            throw std::runtime_error("Not a journal file: '" + path + "'");
+        }
+
+        std::vector<OrderRequest> requests;
+        JournalRecord record{};
+        while (in.read(reinterpret_cast<char *>(&record), sizeof(record)))
+        {
+            OrderRequest request;
+            request.type = static_cast<RequestType>(record.type);
+            request.side = static_cast<OrderSide>(record.side);
+            request.orderType = static_cast<OrderType>(record.orderType);
+            request.timeInForce = static_cast<TimeInForce>(record.timeInForce);
+            request.orderId = record.orderId;
+            request.price = record.price;
+            request.quantity = record.quantity;
+            request.peakQuantity = record.peakQuantity;
+            request.timestamp = record.timestamp;
+            requests.push_back(request);
+        }
+        return requests;
+    }
+
+} // namespace orderbook
@@ -0,0 +1,417 @@
+#include "MatchingEngine.h"
+#include "ThreadAffinity.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace orderbook
+{
+
+    MatchingEngine::MatchingEngine(const MatchingEngineOptions &options)
+        : options_(options)
+    {
+        options_.shards = std::max<std::size_t>(options_.shards, 1);
+        options_.maxBatch = std::max<std::size_t>(options_.maxBatch, 1);
+        for (std::size_t i = 0; i < options_.shards; ++i)
+        {
+            shards_.push_back(std::make_unique<Shard>(options_));
+        }
+    }
+
+    MatchingEngine::~MatchingEngine()
+    {
+        stop();
+    }
+
+    SymbolId MatchingEngine::addSymbol(const std::string &name, const BookOptions &options, int shard)
+    {
+        if (started_)
+        {
+            throw std::invalid_argument("Symbols must be added before the engine starts");
+        }
+        if (names_.count(name))
+        {
+            throw std::invalid_argument("Duplicate symbol '" + name + "'");
+        }
+        // JournalWriter::append has a single producer; two symbols could sit on different shards
+        for (const auto &symbol : symbols_)
+        {
+            if (options.journal && symbol->book.journal() == options.journal)
+            {
+                throw std::invalid_argument("Symbol '" + name + "' shares its journal with '" + symbol->name + "'");
+            }
+        }
+
+        const SymbolId id = static_cast<SymbolId>(symbols_.size());
+        const std::uint32_t owner = static_cast<std::uint32_t>(
+            shard >= 0 ? static_cast<std::size_t>(shard) % shards_.size() : id % shards_.size());
+        symbols_.push_back(std::make_unique<Symbol>(name, options, owner));
+        names_.emplace(name, id);
+        return id;
+    }
+
+    bool MatchingEngine::findSymbol(const std::string &name, SymbolId &id) const
+    {
+        auto it = names_.find(name);
+        if (it == names_.end())
+        {
+            return false;
+        }
+        id = it->second;
+        return true;
+    }
+
+    OrderBook &MatchingEngine::book(SymbolId symbol)
+    {
+        return symbols_.at(symbol)->book;
+    }
+
+    void MatchingEngine::start()
+    {
+        if (started_)
+        {
+            return;
+        }
+        started_ = true;
+        stopping_.store(false, std::memory_order_relaxed);
+        for (auto &shard : shards_)
+        {
+            shard->adoptions = std::make_unique<MpscRing<SymbolId>>(std::max<std::size_t>(symbols_.size(), 1));
+        }
+        for (std::size_t i = 0; i < shards_.size(); ++i)
+        {
+            shards_[i]->thread = std::thread([this, i]
+                                             { run(i); });
+        }
+    }
+
+    void MatchingEngine::stop()
+    {
+        if (!started_)
+        {
+            return;
+        }
+        {
+            // Let in-flight moves land so no adoption is left to a stopped shard
+            std::lock_guard<std::mutex> lock(controlMutex_);
+            for (const auto &symbol : symbols_)
+            {
+                while (symbol->owner.load(std::memory_order_acquire) !=
+                       symbol->route.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        stopping_.store(true, std::memory_order_release);
+        for (auto &shard : shards_)
+        {
+            shard->waiter.notify();
+        }
+        for (auto &shard : shards_)
+        {
+            if (shard->thread.joinable())
+            {
+                shard->thread.join();
+            }
+        }
+        started_ = false;
+    }
+
+    void MatchingEngine::submit(SymbolId symbol, const EngineCommand &command)
+    {
+        Symbol &entry = *symbols_[symbol];
+
+        // Announce the submit before reading the route so that a concurrent
+        // move either sees it in flight or we see the move in progress
+        for (;;)
+        {
+            entry.writers.fetch_add(1, std::memory_order_seq_cst);
+            const std::uint32_t route = entry.route.load(std::memory_order_seq_cst);
+            if ((route & Symbol::kMigrating) == 0)
+            {
+                push(route, ShardCommand{command, symbol, ShardCommandKind::Order, 0});
+                entry.writers.fetch_sub(1, std::memory_order_release);
+                return;
+            }
+            entry.writers.fetch_sub(1, std::memory_order_release);
+            while (entry.route.load(std::memory_order_acquire) & Symbol::kMigrating)
+            {
+                cpuRelax();
+            }
+        }
+    }
+
+    void MatchingEngine::push(std::size_t shardIndex, const ShardCommand &command)
+    {
+        Shard &shard = *shards_[shardIndex];
+        while (!shard.ingress.tryPush(command))
+        {
+            cpuRelax();
+        }
+        shard.waiter.notify();
+    }
+
+    std::size_t MatchingEngine::pollAcks(SymbolAck *out, std::size_t maxCount)
+    {
+        // Round-robin start so one busy shard cannot starve the others
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < shards_.size() && total < maxCount; ++i)
+        {
+            Shard &shard = *shards_[(nextAckShard_ + i) % shards_.size()];
+            total += shard.egress.popBatch(out + total, maxCount - total);
+        }
+        nextAckShard_ = (nextAckShard_ + 1) % shards_.size();
+        return total;
+    }
+
+    std::size_t MatchingEngine::shardOf(SymbolId symbol) const
+    {
+        return symbols_[symbol]->route.load(std::memory_order_acquire) & ~Symbol::kMigrating;
+    }
+
+    void MatchingEngine::moveSymbol(SymbolId symbol, std::size_t shard)
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        Symbol &entry = *symbols_.at(symbol);
+        const std::uint32_t from = entry.route.load(std::memory_order_acquire);
+        const std::uint32_t to = static_cast<std::uint32_t>(shard % shards_.size());
+        if (from == to)
+        {
+            return;
+        }
+
+        if (!started_)
+        {
+            entry.route.store(to, std::memory_order_relaxed);
+            entry.owner.store(to, std::memory_order_relaxed);
+            return;
+        }
+
+        // A symbol still on its way from an earlier move has no owner to release it yet
+        while (entry.owner.load(std::memory_order_acquire) != from)
+        {
+            std::this_thread::yield();
+        }
+
+        // Hold new submits for this symbol and wait out those already routed
+        entry.route.store(from | Symbol::kMigrating, std::memory_order_seq_cst);
+        while (entry.writers.load(std::memory_order_seq_cst) != 0)
+        {
+            cpuRelax();
+        }
+
+        // Every command routed to the old shard is now ahead of this marker
+        push(from, ShardCommand{EngineCommand(), symbol, ShardCommandKind::Release, to});
+        entry.route.store(to, std::memory_order_release);
+    }
+
+    std::size_t MatchingEngine::rebalance(std::size_t maxMoves)
+    {
+        // Load per shard and per symbol since the previous call
+        std::vector<std::uint64_t> shardLoad(shards_.size(), 0);
+        std::vector<std::uint64_t> symbolLoad(symbols_.size(), 0);
+        for (std::size_t id = 0; id < symbols_.size(); ++id)
+        {
+            Symbol &entry = *symbols_[id];
+            const std::uint64_t processed = entry.processed.load(std::memory_order_relaxed);
+            symbolLoad[id] = processed - entry.processedAtLastRebalance;
+            entry.processedAtLastRebalance = processed;
+            shardLoad[shardOf(static_cast<SymbolId>(id))] += symbolLoad[id];
+        }
+
+        std::size_t moves = 0;
+        while (moves < maxMoves)
+        {
+            const auto busiest = std::max_element(shardLoad.begin(), shardLoad.end()) - shardLoad.begin();
+            const auto idlest = std::min_element(shardLoad.begin(), shardLoad.end()) - shardLoad.begin();
+            const std::uint64_t gap = shardLoad[busiest] - shardLoad[idlest];
+            if (busiest == idlest || gap == 0)
+            {
+                break;
+            }
+
+            // The hottest symbol whose move narrows the gap (load below the gap)
+            SymbolId candidate = 0;
+            std::uint64_t candidateLoad = 0;
+            for (std::size_t id = 0; id < symbols_.size(); ++id)
+            {
+                if (shardOf(static_cast<SymbolId>(id)) == static_cast<std::size_t>(busiest) &&
+                    symbolLoad[id] < gap && symbolLoad[id] > candidateLoad)
+                {
+                    candidate = static_cast<SymbolId>(id);
+                    candidateLoad = symbolLoad[id];
+                }
+            }
+            if (candidateLoad == 0)
+            {
+                break;
+            }
+
+            moveSymbol(candidate, static_cast<std::size_t>(idlest));
+            shardLoad[busiest] -= candidateLoad;
+            shardLoad[idlest] += candidateLoad;
+            ++moves;
+        }
+        return moves;
+    }
+
+    std::uint64_t MatchingEngine::processedCommands() const
+    {
+        std::uint64_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            total += shard->processed.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void MatchingEngine::run(std::size_t shardIndex)
+    {
+        Shard &shard = *shards_[shardIndex];
+        if (shardIndex < options_.cpus.size())
+        {
+            pinCurrentThread(options_.cpus[shardIndex]);
+        }
+
+        const std::size_t maxBatch = options_.maxBatch;
+        std::vector<ShardCommand> batch(maxBatch);
+        std::vector<EngineCommand> pending(maxBatch);
+        std::vector<OrderRequest> requests(maxBatch);
+        std::vector<OrderResult> results(maxBatch);
+
+        for (;;)
+        {
+            shard.heldAcks.release([&shard](const SymbolAck &ack)
+                                   { publish(shard, ack); });
+
+            // Symbols handed over since the last batch; their parked commands go first
+            SymbolId adopted;
+            while (shard.adoptions->tryPop(adopted))
+            {
+                adopt(shardIndex, adopted, requests.data(), results.data());
+            }
+
+            const std::size_t count = shard.ingress.popBatch(batch.data(), batch.size());
+            if (count == 0)
+            {
+                const bool stopping = stopping_.load(std::memory_order_acquire);
+                if (stopping && shard.ingress.empty() && shard.heldAcks.empty())
+                {
+                    break;
+                }
+                if (!shard.heldAcks.empty())
+                {
+                    // A group commit is in flight: poll for it rather than sleep past it
+                    std::this_thread::yield();
+                }
+                else if (!stopping)
+                {
+                    shard.waiter.idle([&]
+                                      { return !shard.ingress.empty() || !shard.adoptions->empty() ||
+                                               stopping_.load(std::memory_order_acquire); });
+                }
+                continue;
+            }
+
+            // Consecutive commands for one symbol go to its book as one batch
+            std::size_t runLength = 0;
+            SymbolId runSymbol = 0;
+            auto flush = [&]
+            {
+                if (runLength > 0)
+                {
+                    apply(shard, runSymbol, pending.data(), runLength, requests.data(), results.data());
+                    runLength = 0;
+                }
+            };
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const ShardCommand &command = batch[i];
+                Symbol &entry = *symbols_[command.symbol];
+
+                if (command.kind == ShardCommandKind::Release)
+                {
+                    flush();
+                    entry.owner.store(Symbol::kMigrating, std::memory_order_release);
+                    Shard &target = *shards_[command.target];
+                    target.adoptions->tryPush(command.symbol); // Never full, see Shard::adoptions
+                    target.waiter.notify();
+                    continue;
+                }
+
+                // Routed here before the previous owner has released the book
+                if (entry.owner.load(std::memory_order_relaxed) != shardIndex)
+                {
+                    flush();
+                    shard.parked[command.symbol].push_back(command.command);
+                    continue;
+                }
+
+                if (runLength > 0 && runSymbol != command.symbol)
+                {
+                    flush();
+                }
+                runSymbol = command.symbol;
+                pending[runLength++] = command.command;
+            }
+            flush();
+        }
+    }
+
+    void MatchingEngine::adopt(std::size_t shardIndex, SymbolId symbol, OrderRequest *requests, OrderResult *results)
+    {
+        Shard &shard = *shards_[shardIndex];
+        symbols_[symbol]->owner.store(static_cast<std::uint32_t>(shardIndex), std::memory_order_release);
+
+        auto parked = shard.parked.find(symbol);
+        if (parked == shard.parked.end())
+        {
+            return;
+        }
+        const std::size_t maxBatch = options_.maxBatch;
+        const std::vector<EngineCommand> &early = parked->second;
+        for (std::size_t start = 0; start < early.size(); start += maxBatch)
+        {
+            apply(shard, symbol, early.data() + start, std::min(maxBatch, early.size() - start), requests, results);
+        }
+        shard.parked.erase(parked);
+    }
+
+    void MatchingEngine::apply(Shard &shard, SymbolId symbol, const EngineCommand *commands, std::size_t count,
+                               OrderRequest *requests, OrderResult *results)
+    {
+        Symbol &entry = *symbols_[symbol];
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            requests[i] = commands[i].request;
+        }
+        entry.book.submitBatch(requests, count, results);
+        entry.processed.store(entry.processed.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        shard.processed.store(shard.processed.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+
+        if (!options_.acks)
+        {
+            return;
+        }
+        JournalWriter *journal = entry.book.journal();
+        const std::uint64_t sequence = entry.book.journalSequence();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            shard.heldAcks.push(journal, sequence,
+                                SymbolAck{symbol, EngineAck{commands[i].clientTag, commands[i].request.orderId, results[i]}},
+                                [&shard](const SymbolAck &ack)
+                                { publish(shard, ack); });
+        }
+    }
+
+    void MatchingEngine::publish(Shard &shard, const SymbolAck &ack)
+    {
+        // Backpressure only: the ack consumer is a full ring behind
+        while (!shard.egress.tryPush(ack))
+        {
+            cpuRelax();
+        }
+    }
+
+} // namespace orderbook
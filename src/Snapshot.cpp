@@ -0,0 +1,218 @@
+#include "Snapshot.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace orderbook
+{
+
+    namespace
+    {
+        constexpr char kSnapshotMagic[8] = {'O', 'B', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+#if defined(_WIN32)
+        bool syncFile(const std::string &path)
+        {
+            const int fd = ::_open(path.c_str(), _O_RDWR | _O_BINARY);
+            if (fd < 0)
+            {
+                return false;
+            }
+            const bool synced = ::_commit(fd) == 0;
+            ::_close(fd);
+            return synced;
+        }
+
+        // NTFS journals the rename itself; a directory cannot be flushed through the CRT
+        bool syncDirectory(const std::string &)
+        {
+            return true;
+        }
+
+        // No mmap: read the whole file into one heap block instead
+        void *mapFile(const std::string &path, std::size_t &size)
+        {
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in)
+            {
+                throw std::runtime_error("Cannot open snapshot '" + path + "': " + std::strerror(errno));
+            }
+            size = static_cast<std::size_t>(in.tellg());
+            if (size < sizeof(SnapshotHeader))
+            {
+                throw std::runtime_error("Not a snapshot file: '" + path + "'");
+            }
+            void *data = ::operator new(size);
+            if (!in.seekg(0).read(static_cast<char *>(data), static_cast<std::streamsize>(size)))
+            {
+                ::operator delete(data);
+                throw std::runtime_error("Cannot read snapshot '" + path + "'");
+            }
+            return data;
+        }
+
+        void unmapFile(void *data, std::size_t)
+        {
+            ::operator delete(data);
+        }
+#else
+        bool syncPath(const std::string &path, int flags)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | flags);
+            if (fd < 0)
+            {
+                return false;
+            }
+            const bool synced = ::fsync(fd) == 0;
+            ::close(fd);
+            return synced;
+        }
+
+        bool syncFile(const std::string &path)
+        {
+            return syncPath(path, 0);
+        }
+
+        bool syncDirectory(const std::string &path)
+        {
+            return syncPath(path, O_DIRECTORY);
+        }
+
+        void *mapFile(const std::string &path, std::size_t &size)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot open snapshot '" + path + "': " + std::strerror(errno));
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(SnapshotHeader))
+            {
+                ::close(fd);
+                throw std::runtime_error("Not a snapshot file: '" + path + "'");
+            }
+
+            size = static_cast<std::size_t>(info.st_size);
+            int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+            // Fault the whole file in up front instead of one page per loader miss
+            flags |= MAP_POPULATE;
+#endif
+            void *data = ::mmap(nullptr, size, PROT_READ, flags, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED)
+            {
+                throw std::runtime_error("Cannot map snapshot '" + path + "': " + std::strerror(errno));
+            }
+
+            // The loader reads every record once, front to back
+            ::madvise(data, size, MADV_SEQUENTIAL);
+            return data;
+        }
+
+        void unmapFile(void *data, std::size_t size)
+        {
+            ::munmap(data, size);
+        }
+#endif
+    } // namespace
+
+    SnapshotHeader makeSnapshotHeader()
+    {
+        SnapshotHeader header{};
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        header.version = kSnapshotVersion;
+        header.recordSize = sizeof(SnapshotRecord);
+        header.byteOrder = kSnapshotByteOrder;
+        return header;
+    }
+
+    SnapshotWriter::SnapshotWriter(const std::string &path, SnapshotHeader header)
+        : path_(path), tempPath_(path + ".tmp"), out_(tempPath_, std::ios::binary | std::ios::trunc)
+    {
+        if (!out_)
+        {
+            throw std::runtime_error("Cannot create snapshot '" + tempPath_ + "'");
+        }
+        out_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        buffer_.reserve(kBufferRecords);
+    }
+
+    void SnapshotWriter::flush()
+    {
+        out_.write(reinterpret_cast<const char *>(buffer_.data()),
+                   static_cast<std::streamsize>(buffer_.size() * sizeof(SnapshotRecord)));
+        buffer_.clear();
+    }
+
+    void SnapshotWriter::finish()
+    {
+        flush();
+        out_.close();
+        // The data must be on disk before the rename can publish it, and the
+        // rename itself only survives a crash once the directory is synced
+        if (!out_ || !syncFile(tempPath_))
+        {
+            std::remove(tempPath_.c_str());
+            throw std::runtime_error("Cannot write snapshot '" + tempPath_ + "'");
+        }
+        if (std::rename(tempPath_.c_str(), path_.c_str()) != 0)
+        {
+            throw std::runtime_error("Cannot move snapshot into place at '" + path_ + "'");
+        }
+        std::filesystem::path directory = std::filesystem::path(path_).parent_path();
+        if (directory.empty())
+        {
+            directory = ".";
+        }
+        if (!syncDirectory(directory.string()))
+        {
+            throw std::runtime_error("Cannot sync directory of snapshot '" + path_ + "'");
+        }
+    }
+
+    MappedSnapshot::MappedSnapshot(const std::string &path)
+    {
+        data_ = mapFile(path, size_);
+
+        // The counts are untrusted: bound each by the records the file can
+        // hold before multiplying, so a crafted header cannot wrap the size
+        const SnapshotHeader &h = header();
+        const std::uint64_t capacity = (size_ - sizeof(SnapshotHeader)) / sizeof(SnapshotRecord);
+        const bool valid = std::memcmp(h.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0 &&
+                           h.version == kSnapshotVersion && h.recordSize == sizeof(SnapshotRecord) &&
+                           h.byteOrder == kSnapshotByteOrder &&
+                           h.bidOrders <= capacity && h.askOrders <= capacity - h.bidOrders &&
+                           size_ == sizeof(SnapshotHeader) + (h.bidOrders + h.askOrders) * sizeof(SnapshotRecord);
+        if (!valid)
+        {
+            unmapFile(data_, size_);
+            data_ = nullptr;
+            throw std::runtime_error("Not a snapshot file or truncated: '" + path + "'");
+        }
+    }
+
+    MappedSnapshot::~MappedSnapshot()
+    {
+        if (data_)
+        {
+            unmapFile(data_, size_);
+        }
+    }
+
+} // namespace orderbook
@@ -1,9 +1,21 @@
+#include "DepthFeed.h"
+#include "EngineThread.h"
+#include "MatchingEngine.h"
+#include "MpscRing.h"
 #include "OrderBook.h"
 #include <iostream>
 #include <cassert>
 #include <vector>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <cstdio>
+#include <filesystem>
 #include <thread>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
 
 using namespace orderbook;
 
@@ -247,6 +259,1860 @@ void testPriceTimePriority()
     ASSERT_EQ(trades[1].quantity, 50);
 }
 
+void testTickPriceLevels()
+{
+    OrderBook book(0.05);
+
+    // Prices that differ only by floating-point noise must land on the same level
+    auto buy1 = std::make_shared<Order>(1, OrderSide::BUY, 100.1, 100);
+    auto buy2 = std::make_shared<Order>(2, OrderSide::BUY, 100.10000000001, 50);
+    book.addOrder(buy1);
+    book.addOrder(buy2);
+
+    ASSERT_EQ(book.getTickSize(), 0.05);
+    ASSERT_EQ(book.toTicks(100.1), 2002);
+    ASSERT_EQ(book.toPrice(2002), 100.1);
+    ASSERT_EQ(book.getDepthAtPrice(100.1, OrderSide::BUY), 150);
+    ASSERT_EQ(book.getBestBid().value(), 100.1);
+
+    auto sell1 = std::make_shared<Order>(3, OrderSide::SELL, 100.25, 10);
+    book.addOrder(sell1);
+    ASSERT_EQ(book.getSpread().value(), 0.15);
+
+    // Cancelling one order keeps the shared level alive
+    ASSERT_TRUE(book.cancelOrder(1));
+    ASSERT_EQ(book.getDepthAtPrice(100.10000000001, OrderSide::BUY), 50);
+}
+
+void testOffGridPricesRejected()
+{
+    OrderBook book(0.05);
+    std::vector<Trade> trades;
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+
+    book.addOrder(1, OrderSide::SELL, 100.15, 10);
+
+    // 100.13 would round to 100.15 and fill above the buyer's limit
+    ASSERT_TRUE(book.addOrder(2, OrderSide::BUY, 100.13, 10) == OrderResult::InvalidPrice);
+    ASSERT_TRUE(book.addOrder(3, OrderSide::BUY, std::nan(""), 10) == OrderResult::InvalidPrice);
+    ASSERT_TRUE(book.addOrder(4, OrderSide::BUY, std::numeric_limits<double>::infinity(), 10) == OrderResult::InvalidPrice);
+    ASSERT_FALSE(book.addOrder(Order(5, OrderSide::BUY, 100.17, 10)));
+    ASSERT_FALSE(book.modifyOrder(1, 100.12, 10));
+    ASSERT_TRUE(trades.empty());
+    ASSERT_EQ(book.getOrderCount(), 1u);
+    ASSERT_EQ(book.getDepthAtPrice(100.15, OrderSide::SELL), 10u);
+
+    bool bulkRejected = false;
+    OrderRequest offGrid{RequestType::Add, OrderSide::BUY, 6, 99.99, 10, 0};
+    try
+    {
+        book.loadRestingOrders(&offGrid, 1);
+    }
+    catch (const std::invalid_argument &)
+    {
+        bulkRejected = true;
+    }
+    ASSERT_TRUE(bulkRejected);
+
+    // On-grid prices with floating-point noise are still accepted
+    ASSERT_TRUE(book.addOrder(7, OrderSide::BUY, 100.15000000001, 10) == OrderResult::Accepted);
+    ASSERT_EQ(trades.size(), 1u);
+}
+
+// Inserts `count` orders at a single price
+void fillSingleLevel(OrderBook &book, std::uint64_t count)
+{
+    for (std::uint64_t id = 1; id <= count; ++id)
+    {
+        book.addOrder(std::make_shared<Order>(id, OrderSide::SELL, 100.00, 1));
+    }
+}
+
+void testCancelPreservesQueueOrder()
+{
+    OrderBook book;
+    std::vector<Trade> trades;
+
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+
+    for (std::uint64_t id = 1; id <= 5; ++id)
+    {
+        book.addOrder(std::make_shared<Order>(id, OrderSide::SELL, 101.00, 10));
+    }
+
+    // Cancel from the middle, the head and the tail of the queue
+    ASSERT_TRUE(book.cancelOrder(3));
+    ASSERT_TRUE(book.cancelOrder(1));
+    ASSERT_TRUE(book.cancelOrder(5));
+    ASSERT_FALSE(book.cancelOrder(3));
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::SELL), 20);
+
+    book.addOrder(std::make_shared<Order>(6, OrderSide::BUY, 101.00, 20));
+
+    ASSERT_EQ(trades.size(), 2);
+    ASSERT_EQ(trades[0].sellOrderId, 2);
+    ASSERT_EQ(trades[1].sellOrderId, 4);
+    ASSERT_EQ(book.getOrderCount(), 0);
+    ASSERT_FALSE(book.getBestAsk().has_value());
+}
+
+void testSingleLevelInsertStress()
+{
+    const std::uint64_t largeCount = 100000;
+
+    // Insert cost against depth is measured by orderbook_cancel_bench
+    OrderBook largeBook;
+    std::vector<std::uint64_t> fills;
+    largeBook.setTradeCallback([&](const Trade &trade)
+                               { fills.push_back(trade.sellOrderId); });
+    fillSingleLevel(largeBook, largeCount);
+
+    ASSERT_EQ(largeBook.getOrderCount(), largeCount);
+    ASSERT_EQ(largeBook.getDepthAtPrice(100.00, OrderSide::SELL), largeCount);
+
+    // Sweeping the level must fill strictly in arrival order
+    largeBook.addOrder(std::make_shared<Order>(largeCount + 1, OrderSide::BUY, 100.00, largeCount));
+
+    bool fifo = fills.size() == largeCount;
+    for (std::size_t i = 0; fifo && i < fills.size(); ++i)
+    {
+        fifo = fills[i] == i + 1;
+    }
+    ASSERT_TRUE(fifo);
+    ASSERT_EQ(largeBook.getOrderCount(), 0);
+}
+
+void testOrderPoolRecycling()
+{
+    OrderPool pool(4);
+
+    Order *first = pool.create(1, OrderSide::BUY, 100.00, 10);
+    ASSERT_EQ(pool.capacity(), 4);
+    ASSERT_EQ(pool.inUse(), 1);
+    ASSERT_EQ(first->orderId, 1);
+
+    // A released slot is handed out again before the pool grows
+    pool.destroy(first);
+    Order *second = pool.create(2, OrderSide::SELL, 101.00, 20);
+    ASSERT_TRUE(second == first);
+    ASSERT_EQ(second->orderId, 2);
+
+    for (std::uint64_t id = 3; id <= 6; ++id)
+    {
+        pool.create(id, OrderSide::BUY, 99.00, 1);
+    }
+    ASSERT_EQ(pool.capacity(), 8);
+    ASSERT_EQ(pool.inUse(), 5);
+
+    // Growing adds a slab; orders already handed out stay where they are
+    std::vector<Order *> held;
+    for (std::uint64_t id = 7; id <= 40; ++id)
+    {
+        held.push_back(pool.create(id, OrderSide::BUY, 99.00, id));
+    }
+    ASSERT_TRUE(second->orderId == 2 && second->quantity == 20);
+    bool stable = true;
+    for (std::size_t i = 0; i < held.size(); ++i)
+    {
+        stable = stable && held[i]->orderId == 7 + i && held[i]->quantity == 7 + i;
+    }
+    ASSERT_TRUE(stable);
+
+    // Freed slots are reused rather than growing the pool again
+    const std::size_t grown = pool.capacity();
+    for (Order *order : held)
+    {
+        pool.destroy(order);
+    }
+    for (std::uint64_t id = 100; id < 100 + held.size(); ++id)
+    {
+        pool.create(id, OrderSide::SELL, 101.00, 1);
+    }
+    ASSERT_EQ(pool.capacity(), grown);
+
+    // Orders passed by value are copied into the book, not aliased
+    OrderBook book;
+    Order order(10, OrderSide::BUY, 100.00, 100);
+    ASSERT_TRUE(book.addOrder(order));
+    ASSERT_FALSE(book.addOrder(order));
+    book.addOrder(Order(11, OrderSide::SELL, 100.00, 40));
+    ASSERT_EQ(order.quantity, 100);
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::BUY), 60);
+    ASSERT_FALSE(book.addOrder(OrderBook::OrderPtr()));
+}
+
+void testLadderBackend()
+{
+    BookOptions options;
+    options.levelStorage = LevelStorage::Ladder;
+    options.ladderTicks = 64;
+    OrderBook book(options);
+    std::vector<Trade> trades;
+
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+
+    book.addOrder(Order(1, OrderSide::BUY, 100.00, 10));
+    book.addOrder(Order(2, OrderSide::BUY, 99.50, 10));
+    book.addOrder(Order(3, OrderSide::SELL, 100.20, 10));
+
+    // Far outside the initial 64-tick window: forces a re-centre and growth
+    book.addOrder(Order(4, OrderSide::BUY, 90.00, 10));
+    book.addOrder(Order(5, OrderSide::SELL, 110.00, 10));
+
+    ASSERT_EQ(book.getBestBid().value(), 100.00);
+    ASSERT_EQ(book.getBestAsk().value(), 100.20);
+    ASSERT_EQ(book.getDepthAtPrice(90.00, OrderSide::BUY), 10);
+
+    // Emptying the best level moves the touch to the next occupied slot
+    ASSERT_TRUE(book.cancelOrder(1));
+    ASSERT_EQ(book.getBestBid().value(), 99.50);
+
+    // Sweep through the gap to the far level
+    book.addOrder(Order(6, OrderSide::SELL, 90.00, 15));
+    ASSERT_EQ(trades.size(), 2);
+    ASSERT_EQ(trades[1].buyOrderId, 4);
+    ASSERT_EQ(book.getBestBid().value(), 90.00);
+    ASSERT_EQ(book.getDepthAtPrice(90.00, OrderSide::BUY), 5);
+}
+
+void testLadderWindowCap()
+{
+    BookOptions options;
+    options.levelStorage = LevelStorage::Ladder;
+    options.tickSize = 1.0;
+    options.ladderTicks = 64;
+    options.maxLadderTicks = 1024;
+    OrderBook book(options);
+
+    ASSERT_TRUE(book.addOrder(1, OrderSide::BUY, 100, 10) == OrderResult::Accepted);
+
+    // One outlier must not grow the window without bound; the book is untouched
+    ASSERT_TRUE(book.addOrder(2, OrderSide::BUY, 1e7, 10) == OrderResult::PriceOutOfRange);
+    ASSERT_TRUE(book.addOrder(3, OrderSide::SELL, 1e7, 10) == OrderResult::Accepted);
+    ASSERT_TRUE(book.addOrder(4, OrderSide::SELL, 1e7 + 2000, 10) == OrderResult::PriceOutOfRange);
+    ASSERT_FALSE(book.modifyOrder(1, 5000, 10));
+    ASSERT_EQ(book.getOrderCount(), 2u);
+    ASSERT_EQ(book.getBestBid().value(), 100.0);
+    ASSERT_FALSE(book.cancelOrder(2));
+
+    // Immediate orders never rest, so any price is fine for them
+    ASSERT_TRUE(book.addOrder(5, OrderSide::SELL, 1e6, 5, TimeInForce::ImmediateOrCancel) == OrderResult::Accepted);
+
+    // Within the cap the window still grows
+    ASSERT_TRUE(book.addOrder(6, OrderSide::BUY, 1000, 10) == OrderResult::Accepted);
+    ASSERT_EQ(book.getBestBid().value(), 1000.0);
+
+    bool bulkRejected = false;
+    OrderRequest outlier{RequestType::Add, OrderSide::BUY, 7, 1e8, 10, 0};
+    try
+    {
+        book.loadRestingOrders(&outlier, 1);
+    }
+    catch (const std::invalid_argument &)
+    {
+        bulkRejected = true;
+    }
+    ASSERT_TRUE(bulkRejected);
+    ASSERT_EQ(book.getOrderCount(), 3u);
+}
+
+void testLadderMatchesMapBackend()
+{
+    BookOptions ladderOptions;
+    ladderOptions.levelStorage = LevelStorage::Ladder;
+    ladderOptions.ladderTicks = 32;
+    OrderBook mapBook;
+    OrderBook ladderBook(ladderOptions);
+
+    std::vector<Trade> mapTrades;
+    std::vector<Trade> ladderTrades;
+    mapBook.setTradeCallback([&](const Trade &trade)
+                             { mapTrades.push_back(trade); });
+    ladderBook.setTradeCallback([&](const Trade &trade)
+                                { ladderTrades.push_back(trade); });
+
+    std::mt19937 rng(1234);
+    bool same = true;
+    for (std::uint64_t id = 1; id <= 20000 && same; ++id)
+    {
+        if (rng() % 3 == 0)
+        {
+            std::uint64_t victim = 1 + rng() % id;
+            same = mapBook.cancelOrder(victim) == ladderBook.cancelOrder(victim);
+            continue;
+        }
+
+        OrderSide side = (rng() & 1) ? OrderSide::BUY : OrderSide::SELL;
+        // Slow drift keeps pushing prices out of the ladder window
+        double price = 50.00 + (id / 200) * 0.10 + static_cast<int>(rng() % 81 - 40) * 0.01;
+        std::uint64_t quantity = 1 + rng() % 50;
+        mapBook.addOrder(Order(id, side, price, quantity));
+        ladderBook.addOrder(Order(id, side, price, quantity));
+
+        same = mapBook.getBestBid() == ladderBook.getBestBid() &&
+               mapBook.getBestAsk() == ladderBook.getBestAsk() &&
+               mapBook.getOrderCount() == ladderBook.getOrderCount() &&
+               mapBook.getDepthAtPrice(price, side) == ladderBook.getDepthAtPrice(price, side) &&
+               mapTrades.size() == ladderTrades.size();
+    }
+    ASSERT_TRUE(same);
+}
+
+void testLevelBitmapSearch()
+{
+    const std::size_t slots = 70000; // Three layers, last word partially used
+    LevelBitmap bitmap(slots);
+    std::set<std::size_t> reference;
+
+    ASSERT_EQ(bitmap.findNext(0), LevelBitmap::npos);
+    ASSERT_EQ(bitmap.findPrev(slots - 1), LevelBitmap::npos);
+
+    bitmap.set(0);
+    bitmap.set(slots - 1);
+    ASSERT_EQ(bitmap.findNext(1), slots - 1);
+    ASSERT_EQ(bitmap.findPrev(slots - 2), 0);
+    bitmap.clear(0);
+    bitmap.clear(slots - 1);
+
+    std::mt19937 rng(99);
+    bool same = true;
+    for (int i = 0; i < 20000 && same; ++i)
+    {
+        std::size_t slot = rng() % slots;
+        if (rng() & 1)
+        {
+            bitmap.set(slot);
+            reference.insert(slot);
+        }
+        else
+        {
+            bitmap.clear(slot);
+            reference.erase(slot);
+        }
+
+        std::size_t probe = rng() % slots;
+        auto next = reference.lower_bound(probe);
+        auto prev = reference.upper_bound(probe);
+        std::size_t expectedNext = next == reference.end() ? LevelBitmap::npos : *next;
+        std::size_t expectedPrev = prev == reference.begin() ? LevelBitmap::npos : *std::prev(prev);
+
+        same = bitmap.findNext(probe) == expectedNext && bitmap.findPrev(probe) == expectedPrev &&
+               bitmap.test(slot) == (reference.count(slot) == 1);
+    }
+    ASSERT_TRUE(same);
+}
+
+void testOrderIdIndex()
+{
+    OrderIdIndex index;
+    std::map<std::uint64_t, Order *> reference;
+    std::vector<Order> storage;
+    storage.reserve(4096);
+    for (std::uint64_t i = 0; i < 4096; ++i)
+    {
+        storage.emplace_back(i, OrderSide::BUY, 100.00, 1);
+    }
+
+    ASSERT_TRUE(index.insert(0, &storage[0]));
+    ASSERT_FALSE(index.insert(0, &storage[1]));
+    ASSERT_TRUE(index.find(0) == &storage[0]);
+    ASSERT_TRUE(index.erase(0));
+    ASSERT_FALSE(index.erase(0));
+    ASSERT_TRUE(index.find(0) == nullptr);
+
+    // Random churn (including growth) must agree with an ordered map
+    std::mt19937 rng(5);
+    bool same = true;
+    for (int i = 0; i < 50000 && same; ++i)
+    {
+        std::uint64_t id = rng() % 4096;
+        if (rng() % 3 == 0)
+        {
+            same = index.erase(id) == (reference.erase(id) == 1);
+        }
+        else
+        {
+            same = index.insert(id, &storage[id]) == reference.emplace(id, &storage[id]).second;
+        }
+        std::uint64_t probe = rng() % 4096;
+        auto it = reference.find(probe);
+        same = same && index.find(probe) == (it == reference.end() ? nullptr : it->second) &&
+               index.size() == reference.size();
+    }
+    ASSERT_TRUE(same);
+
+    index.reserve(100000);
+    ASSERT_TRUE(index.capacity() >= 100000);
+    ASSERT_EQ(index.size(), reference.size());
+
+    // Moving out leaves an empty index with no table that still works
+    OrderIdIndex moved(std::move(index));
+    ASSERT_EQ(moved.size(), reference.size());
+    ASSERT_EQ(index.capacity(), 0u);
+    ASSERT_TRUE(index.find(1) == nullptr);
+    ASSERT_FALSE(index.erase(1));
+    ASSERT_TRUE(index.insert(1, &storage[1]));
+    ASSERT_TRUE(index.find(1) == &storage[1]);
+}
+
+void testLevelAggregates()
+{
+    BookOptions options;
+    options.levelStorage = LevelStorage::Ladder;
+    OrderBook book(options);
+
+    book.addOrder(Order(1, OrderSide::BUY, 100.00, 100));
+    book.addOrder(Order(2, OrderSide::BUY, 100.00, 50));
+    book.addOrder(Order(3, OrderSide::BUY, 100.00, 25));
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::BUY), 175);
+    ASSERT_EQ(book.getOrderCountAtPrice(100.00, OrderSide::BUY), 3);
+
+    // Partial fill of the head order
+    book.addOrder(Order(4, OrderSide::SELL, 100.00, 30));
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::BUY), 145);
+    ASSERT_EQ(book.getOrderCountAtPrice(100.00, OrderSide::BUY), 3);
+
+    // Aggressor that fills the head order and part of the next one
+    book.addOrder(Order(5, OrderSide::SELL, 100.00, 80));
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::BUY), 65);
+    ASSERT_EQ(book.getOrderCountAtPrice(100.00, OrderSide::BUY), 2);
+
+    book.addOrder(Order(6, OrderSide::BUY, 101.00, 40));
+    book.addOrder(Order(7, OrderSide::SELL, 101.00, 10));
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::BUY), 30);
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::SELL), 0);
+
+    // Modify moves quantity between levels; cancel removes it
+    ASSERT_TRUE(book.modifyOrder(2, 101.00, 60));
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::BUY), 25);
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::BUY), 90);
+    ASSERT_EQ(book.getOrderCountAtPrice(101.00, OrderSide::BUY), 2);
+    ASSERT_TRUE(book.cancelOrder(6));
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::BUY), 60);
+    ASSERT_EQ(book.getOrderCountAtPrice(101.00, OrderSide::BUY), 1);
+}
+
+struct CountingListener : BookListener
+{
+    int accepted = 0;
+    int cancelled = 0;
+    std::uint64_t tradedQuantity = 0;
+
+    void onTrade(const Trade &trade) { tradedQuantity += trade.quantity; }
+    void onOrderAccepted(const Order &) { ++accepted; }
+    void onCancel(const Order &) { ++cancelled; }
+};
+
+void testCompileTimeListener()
+{
+    BasicOrderBook<CountingListener> book{BookOptions{}};
+
+    book.addOrder(Order(1, OrderSide::SELL, 100.00, 50));
+    book.addOrder(Order(2, OrderSide::SELL, 100.10, 50));
+    book.addOrder(Order(3, OrderSide::BUY, 100.10, 70));
+    ASSERT_FALSE(book.addOrder(Order(2, OrderSide::BUY, 99.00, 10)));
+    book.cancelOrder(2);
+
+    ASSERT_EQ(book.listener().accepted, 3);
+    ASSERT_EQ(book.listener().cancelled, 1);
+    ASSERT_EQ(book.listener().tradedQuantity, 70);
+    ASSERT_EQ(book.getOrderCount(), 0);
+}
+
+void testTopOfBookNotifications()
+{
+    OrderBook book;
+    std::vector<TopOfBook> updates;
+
+    book.setTopOfBookCallback([&](const TopOfBook &top)
+                              { updates.push_back(top); });
+
+    book.addOrder(Order(1, OrderSide::SELL, 101.00, 10));
+    book.addOrder(Order(2, OrderSide::SELL, 101.50, 20));
+    book.addOrder(Order(3, OrderSide::SELL, 102.00, 30));
+    book.addOrder(Order(4, OrderSide::BUY, 100.00, 40));
+    ASSERT_EQ(updates.size(), 2); // Orders 2 and 3 rest behind the touch
+
+    const TopOfBook &top = book.getTopOfBook();
+    ASSERT_EQ(top.bidPrice, book.toTicks(100.00));
+    ASSERT_EQ(top.bidQuantity, 40);
+    ASSERT_EQ(top.askPrice, book.toTicks(101.00));
+    ASSERT_EQ(top.askOrders, 1);
+
+    // Deep cancel leaves the touch alone
+    book.cancelOrder(3);
+    ASSERT_EQ(updates.size(), 2);
+
+    // A sweep through two levels publishes once, after all fills
+    book.addOrder(Order(5, OrderSide::BUY, 101.50, 25));
+    ASSERT_EQ(updates.size(), 3);
+    ASSERT_EQ(updates.back().askPrice, book.toTicks(101.50));
+    ASSERT_EQ(updates.back().askQuantity, 5);
+    ASSERT_EQ(book.getBestAsk().value(), 101.50);
+
+    book.clear();
+    ASSERT_EQ(updates.size(), 4);
+    ASSERT_FALSE(updates.back().hasBid());
+    ASSERT_FALSE(book.getBestBid().has_value());
+}
+
+struct BatchListener : BookListener
+{
+    std::size_t batches = 0;
+    std::vector<Trade> trades;
+
+    void onTradeBatch(const Trade *batch, std::size_t count)
+    {
+        ++batches;
+        trades.insert(trades.end(), batch, batch + count);
+    }
+};
+
+struct EventLogListener : BookListener
+{
+    std::vector<std::string> events;
+
+    void onTrade(const Trade &trade) { events.push_back("trade " + std::to_string(trade.sellOrderId)); }
+    void onCancel(const Order &order) { events.push_back("cancel " + std::to_string(order.orderId)); }
+};
+
+void testBatchSubmission()
+{
+    OrderBook book;
+    std::vector<Trade> trades;
+    std::size_t topUpdates = 0;
+
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+    book.setTopOfBookCallback([&](const TopOfBook &)
+                              { ++topUpdates; });
+
+    OrderRequest requests[6];
+    requests[0] = {RequestType::Add, OrderSide::SELL, 1, 101.00, 10};
+    requests[1] = {RequestType::Add, OrderSide::SELL, 2, 101.50, 10};
+    requests[2] = {RequestType::Add, OrderSide::SELL, 1, 102.00, 10};
+    requests[3] = {RequestType::Add, OrderSide::BUY, 3, 101.50, 15};
+    requests[4] = {RequestType::Cancel, OrderSide::BUY, 9, 0.0, 0};
+    requests[5] = {RequestType::Modify, OrderSide::SELL, 2, 101.50, 20};
+
+    OrderResult results[6];
+    ASSERT_EQ(book.submitBatch(requests, 6, results), 4);
+    ASSERT_TRUE(results[0] == OrderResult::Accepted);
+    ASSERT_TRUE(results[2] == OrderResult::DuplicateId);
+    ASSERT_TRUE(results[4] == OrderResult::UnknownOrder);
+
+    // Trades are delivered in match order, and the touch is published once per batch
+    ASSERT_EQ(trades.size(), 2);
+    ASSERT_EQ(trades[0].sellOrderId, 1);
+    ASSERT_EQ(trades[1].quantity, 5);
+    ASSERT_EQ(topUpdates, 1);
+    ASSERT_EQ(book.getDepthAtPrice(101.50, OrderSide::SELL), 20);
+
+    // A listener with onTradeBatch receives the whole batch in one call
+    BasicOrderBook<BatchListener> batched;
+    OrderRequest sweep[3];
+    sweep[0] = {RequestType::Add, OrderSide::SELL, 1, 100.00, 5};
+    sweep[1] = {RequestType::Add, OrderSide::SELL, 2, 100.01, 5};
+    sweep[2] = {RequestType::Add, OrderSide::BUY, 3, 100.01, 10};
+    OrderResult sweepResults[3];
+    ASSERT_EQ(batched.submitBatch(sweep, 3, sweepResults), 3);
+    ASSERT_EQ(batched.listener().batches, 1);
+    ASSERT_EQ(batched.listener().trades.size(), 2);
+    ASSERT_EQ(batched.getOrderCount(), 0);
+
+    // A batched IOC reports its fills before the cancel of its remainder
+    BasicOrderBook<EventLogListener> logged;
+    OrderRequest ioc[3];
+    ioc[0] = {RequestType::Add, OrderSide::SELL, 1, 100.00, 5};
+    ioc[1] = {RequestType::Add, OrderSide::SELL, 2, 100.01, 5};
+    ioc[2] = {RequestType::Add, OrderSide::BUY, 3, 100.01, 15, 0, OrderType::Limit, TimeInForce::ImmediateOrCancel};
+    OrderResult iocResults[3];
+    ASSERT_EQ(logged.submitBatch(ioc, 3, iocResults), 3);
+    const std::vector<std::string> expected{"trade 1", "trade 2", "cancel 3"};
+    ASSERT_TRUE(logged.listener().events == expected);
+}
+
+void testEmplaceOrderEntry()
+{
+    OrderBook book;
+    std::vector<Trade> trades;
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+
+    ASSERT_TRUE(book.addOrder(1, OrderSide::SELL, 100.50, 10) == OrderResult::Accepted);
+    ASSERT_TRUE(book.addOrder(1, OrderSide::SELL, 100.75, 10) == OrderResult::DuplicateId);
+    ASSERT_TRUE(book.addOrder(2, OrderSide::BUY, 100.00, 0) == OrderResult::InvalidQuantity);
+    ASSERT_EQ(book.getDepthAtPrice(100.50, OrderSide::SELL), 10);
+
+    ASSERT_TRUE(book.addOrder(3, OrderSide::BUY, 100.50, 4) == OrderResult::Accepted);
+    ASSERT_EQ(trades.size(), 1);
+    ASSERT_EQ(trades[0].quantity, 4);
+    ASSERT_EQ(book.getTopOfBook().askQuantity, 6);
+    ASSERT_EQ(book.getOrderCount(), 1);
+}
+
+void testEngineClock()
+{
+    EngineClock tsc(ClockSource::Tsc);
+    EngineClock system(ClockSource::System);
+
+    // The calibrated counter tracks wall-clock time in nanoseconds
+    std::uint64_t before = EngineClock::systemNow();
+    std::uint64_t a = tsc.now();
+    std::uint64_t b = tsc.now();
+    std::uint64_t after = system.now();
+    ASSERT_TRUE(b >= a);
+    ASSERT_TRUE(a + 1000000 >= before && a <= after + 1000000);
+
+    // One read per message: a sweep stamps every fill with the same time
+    OrderBook book;
+    std::vector<Trade> trades;
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+    book.addOrder(1, OrderSide::SELL, 100.00, 5);
+    book.addOrder(2, OrderSide::SELL, 100.01, 5);
+    book.addOrder(3, OrderSide::SELL, 100.02, 5);
+    before = EngineClock::systemNow();
+    book.addOrder(4, OrderSide::BUY, 100.02, 15);
+    after = EngineClock::systemNow();
+    ASSERT_EQ(trades.size(), 3);
+    ASSERT_EQ(trades[0].timestamp, trades[2].timestamp);
+    ASSERT_TRUE(trades[0].timestamp + 1000000 >= before && trades[0].timestamp <= after + 1000000);
+}
+
+void testReplayClock()
+{
+    // The same recorded flow, replayed twice, must produce identical output
+    auto replay = []()
+    {
+        BookOptions options;
+        options.clock = ClockSource::Replay;
+        OrderBook book(options);
+        std::vector<Trade> trades;
+        book.setTradeCallback([&](const Trade &trade)
+                              { trades.push_back(trade); });
+
+        std::vector<OrderRequest> flow;
+        for (std::uint64_t id = 1; id <= 200; ++id)
+        {
+            OrderRequest request;
+            request.side = (id % 3 == 0) ? OrderSide::BUY : OrderSide::SELL;
+            request.orderId = id;
+            request.price = 100.00 + static_cast<double>(id % 7) * 0.01;
+            request.quantity = 10 + id % 5;
+            request.timestamp = 1700000000000000000ull + id / 4; // Several orders share a timestamp
+            flow.push_back(request);
+        }
+        std::vector<OrderResult> results(flow.size());
+        book.submitBatch(flow.data(), flow.size(), results.data());
+
+        book.clock().set(1700000000000001000ull);
+        book.addOrder(1000, OrderSide::BUY, 100.10, 500);
+        return trades;
+    };
+
+    std::vector<Trade> first = replay();
+    std::vector<Trade> second = replay();
+    ASSERT_TRUE(!first.empty());
+    ASSERT_EQ(first.size(), second.size());
+
+    bool identical = first.size() == second.size();
+    for (std::size_t i = 0; identical && i < first.size(); ++i)
+    {
+        identical = first[i].buyOrderId == second[i].buyOrderId &&
+                    first[i].sellOrderId == second[i].sellOrderId &&
+                    first[i].price == second[i].price &&
+                    first[i].quantity == second[i].quantity &&
+                    first[i].timestamp == second[i].timestamp;
+    }
+    ASSERT_TRUE(identical);
+    ASSERT_EQ(first.back().timestamp, 1700000000000001000ull);
+}
+
+void testJournalRecovery()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "orderbook_journal_test.bin").string();
+    std::remove(path.c_str());
+
+    std::vector<Trade> liveTrades;
+    std::size_t accepted = 0;
+    {
+        JournalOptions journalOptions;
+        journalOptions.path = path;
+        journalOptions.queueCapacity = 64; // Small ring so the writer has to keep up
+        JournalWriter journal(journalOptions);
+
+        BookOptions options;
+        options.journal = &journal;
+        OrderBook book(options);
+        book.setTradeCallback([&](const Trade &trade)
+                              { liveTrades.push_back(trade); });
+
+        for (std::uint64_t id = 1; id <= 300; ++id)
+        {
+            OrderSide side = (id % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
+            double price = side == OrderSide::BUY ? 99.90 + static_cast<double>(id % 13) * 0.01
+                                                  : 100.00 + static_cast<double>(id % 11) * 0.01;
+            accepted += book.addOrder(id, side, price, 10 + id % 4) == OrderResult::Accepted;
+            if (id % 5 == 0)
+            {
+                accepted += book.cancelOrder(id - 3);
+            }
+            if (id % 7 == 0)
+            {
+                accepted += book.modifyOrder(id - 1, 100.05, 25);
+            }
+            if (id % 11 == 0)
+            {
+                accepted += book.addMarketOrder(10000 + id, side, 15) == OrderResult::Accepted;
+            }
+            if (id % 13 == 0)
+            {
+                accepted += book.addIcebergOrder(20000 + id, side, price, 40, 10) == OrderResult::Accepted;
+            }
+        }
+        ASSERT_FALSE(book.addOrder(1000, OrderSide::BUY, 100.00, 0) == OrderResult::Accepted); // Rejected: not journaled
+        ASSERT_EQ(journal.appendedSequence(), accepted);
+
+        ASSERT_TRUE(journal.waitDurable(journal.appendedSequence()));
+        ASSERT_TRUE(journal.groupCommits() >= 1);
+        ASSERT_TRUE(journal.groupCommits() <= accepted);
+        journal.close();
+
+        // Rebuild from the journal alone and compare with the live book
+        std::vector<OrderRequest> replayed = readJournal(path);
+        ASSERT_EQ(replayed.size(), accepted);
+
+        BookOptions replayOptions;
+        replayOptions.clock = ClockSource::Replay;
+        OrderBook rebuilt(replayOptions);
+        std::vector<Trade> replayTrades;
+        rebuilt.setTradeCallback([&](const Trade &trade)
+                                 { replayTrades.push_back(trade); });
+        std::vector<OrderResult> results(replayed.size());
+        ASSERT_EQ(rebuilt.submitBatch(replayed.data(), replayed.size(), results.data()), accepted);
+
+        ASSERT_EQ(rebuilt.getOrderCount(), book.getOrderCount());
+        ASSERT_TRUE(rebuilt.getTopOfBook() == book.getTopOfBook());
+        ASSERT_EQ(replayTrades.size(), liveTrades.size());
+        bool identical = replayTrades.size() == liveTrades.size();
+        for (std::size_t i = 0; identical && i < liveTrades.size(); ++i)
+        {
+            identical = replayTrades[i].buyOrderId == liveTrades[i].buyOrderId &&
+                        replayTrades[i].sellOrderId == liveTrades[i].sellOrderId &&
+                        replayTrades[i].quantity == liveTrades[i].quantity &&
+                        replayTrades[i].timestamp == liveTrades[i].timestamp;
+        }
+        ASSERT_TRUE(identical);
+    }
+
+    // Reopening continues the sequence after the last record
+    {
+        JournalOptions journalOptions;
+        journalOptions.path = path;
+        JournalWriter journal(journalOptions);
+        ASSERT_EQ(journal.durableSequence(), accepted);
+        OrderRequest request;
+        request.orderId = 5000;
+        request.quantity = 1;
+        ASSERT_EQ(journal.append(request), accepted + 1);
+    }
+    ASSERT_EQ(readJournal(path).size(), accepted + 1);
+
+    // A journal written on a host of the other byte order is rejected
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        JournalHeader header{};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        header.byteOrder = 0x04030201;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    bool foreign = false;
+    try
+    {
+        readJournal(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        foreign = true;
+    }
+    ASSERT_TRUE(foreign);
+    std::remove(path.c_str());
+
+    // Snapshot plus journal tail into a journaled live book: the replay
+    // must not append the tail to the journal a second time
+    const std::string snapshotPath = path + ".snapshot";
+    std::vector<Trade> tailTrades;
+    OrderBook live;
+    {
+        JournalOptions journalOptions;
+        journalOptions.path = path;
+        JournalWriter journal(journalOptions);
+        BookOptions options;
+        options.journal = &journal;
+        live = OrderBook(options);
+        for (std::uint64_t id = 1; id <= 100; ++id)
+        {
+            if (id == 60)
+            {
+                live.saveSnapshot(snapshotPath);
+                live.setTradeCallback([&](const Trade &trade)
+                                      { tailTrades.push_back(trade); });
+            }
+            OrderSide side = (id % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
+            live.addOrder(id, side, side == OrderSide::BUY ? 99.95 + (id % 5) * 0.01 : 99.98 + (id % 5) * 0.01, 10);
+            if (id % 9 == 0)
+            {
+                live.cancelOrder(id - 4);
+            }
+        }
+        ASSERT_TRUE(journal.waitDurable(journal.appendedSequence()));
+        journal.close();
+    }
+    {
+        JournalOptions journalOptions;
+        journalOptions.path = path;
+        JournalWriter journal(journalOptions);
+        const std::uint64_t records = journal.appendedSequence();
+
+        BookOptions options;
+        options.journal = &journal;
+        OrderBook recovered(options);
+        std::vector<Trade> replayTrades;
+        recovered.setTradeCallback([&](const Trade &trade)
+                                   { replayTrades.push_back(trade); });
+        const std::uint64_t covered = recovered.loadSnapshot(snapshotPath);
+        ASSERT_TRUE(covered > 0 && covered < records);
+
+        std::vector<OrderRequest> all = readJournal(path);
+        std::vector<OrderRequest> tail(all.begin() + static_cast<std::ptrdiff_t>(covered), all.end());
+        std::vector<OrderResult> results(tail.size());
+        ASSERT_EQ(recovered.replayBatch(tail.data(), tail.size(), results.data()), tail.size());
+        ASSERT_EQ(journal.appendedSequence(), records);
+        ASSERT_EQ(recovered.getOrderCount(), live.getOrderCount());
+        ASSERT_TRUE(recovered.getTopOfBook() == live.getTopOfBook());
+        bool sameTimes = replayTrades.size() == tailTrades.size() && !tailTrades.empty();
+        for (std::size_t i = 0; sameTimes && i < tailTrades.size(); ++i)
+        {
+            sameTimes = replayTrades[i].timestamp == tailTrades[i].timestamp;
+        }
+        ASSERT_TRUE(sameTimes);
+
+        // Live traffic after the replay is journaled as usual
+        ASSERT_EQ(recovered.addOrder(500, OrderSide::BUY, 90.00, 1), OrderResult::Accepted);
+        ASSERT_EQ(journal.appendedSequence(), records + 1);
+    }
+    std::remove(path.c_str());
+    std::remove(snapshotPath.c_str());
+
+    // A snapshot taken while a group commit is still outstanding must not
+    // cover records the journal has not stored yet
+    {
+        JournalOptions journalOptions;
+        journalOptions.path = path;
+        journalOptions.maxBatch = 16;
+        JournalWriter journal(journalOptions);
+        BookOptions options;
+        options.journal = &journal;
+        OrderBook book(options);
+        for (std::uint64_t id = 1; id <= 2000; ++id)
+        {
+            book.addOrder(id, OrderSide::BUY, 90.00 + (id % 50) * 0.01, 10);
+        }
+        book.saveSnapshot(snapshotPath);
+
+        OrderBook restored;
+        const std::uint64_t covered = restored.loadSnapshot(snapshotPath);
+        ASSERT_EQ(covered, book.journalSequence());
+        ASSERT_TRUE(covered <= readJournal(path).size());
+        std::vector<OrderRequest> tail = readJournal(path);
+        tail.erase(tail.begin(), tail.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(covered, tail.size())));
+        ASSERT_TRUE(tail.empty());
+    }
+    std::remove(path.c_str());
+    std::remove(snapshotPath.c_str());
+
+    // A clear is journaled, so replay does not bring the cleared orders back
+    {
+        JournalOptions journalOptions;
+        journalOptions.path = path;
+        JournalWriter journal(journalOptions);
+        BookOptions options;
+        options.journal = &journal;
+        OrderBook book(options);
+        book.addOrder(1, OrderSide::BUY, 99.00, 10);
+        book.addOrder(2, OrderSide::SELL, 101.00, 10);
+        book.clear();
+        ASSERT_EQ(journal.appendedSequence(), 3u);
+        book.addOrder(3, OrderSide::BUY, 98.00, 5);
+        journal.close();
+
+        std::vector<OrderRequest> replayed = readJournal(path);
+        ASSERT_TRUE(replayed.size() == 4 && replayed[2].type == RequestType::Clear);
+        OrderBook rebuilt;
+        std::vector<OrderResult> results(replayed.size());
+        ASSERT_EQ(rebuilt.replayBatch(replayed.data(), replayed.size(), results.data()), replayed.size());
+        ASSERT_EQ(rebuilt.getOrderCount(), 1u);
+        ASSERT_TRUE(rebuilt.getTopOfBook() == book.getTopOfBook());
+    }
+    std::remove(path.c_str());
+}
+
+void testSnapshotRoundTrip()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "orderbook_snapshot_test.bin").string();
+
+    for (LevelStorage storage : {LevelStorage::Map, LevelStorage::Ladder})
+    {
+        BookOptions options;
+        options.levelStorage = storage;
+        options.ladderTicks = 16; // Force re-centring while loading
+        OrderBook original(options);
+        for (std::uint64_t id = 1; id <= 400; ++id)
+        {
+            OrderSide side = (id % 2 == 0) ? OrderSide::BUY : OrderSide::SELL;
+            double price = side == OrderSide::BUY ? 99.50 + static_cast<double>(id % 37) * 0.01
+                                                  : 100.00 + static_cast<double>(id % 41) * 0.01;
+            original.addOrder(id, side, price, 5 + id % 9);
+        }
+        original.cancelOrder(10);
+        original.addOrder(500, OrderSide::BUY, 100.02, 12); // Partially fills the ask touch
+        original.saveSnapshot(path);
+
+        OrderBook restored(options);
+        std::size_t topUpdates = 0;
+        restored.setTopOfBookCallback([&](const TopOfBook &)
+                                      { ++topUpdates; });
+        ASSERT_EQ(restored.loadSnapshot(path), 0);
+        ASSERT_EQ(topUpdates, 1);
+        ASSERT_EQ(restored.getOrderCount(), original.getOrderCount());
+        ASSERT_TRUE(restored.getTopOfBook() == original.getTopOfBook());
+
+        bool sameDepth = true;
+        for (int tick = 9940; tick <= 10050; ++tick)
+        {
+            double price = tick * 0.01;
+            sameDepth = sameDepth &&
+                        restored.getDepthAtPrice(price, OrderSide::BUY) == original.getDepthAtPrice(price, OrderSide::BUY) &&
+                        restored.getOrderCountAtPrice(price, OrderSide::SELL) == original.getOrderCountAtPrice(price, OrderSide::SELL);
+        }
+        ASSERT_TRUE(sameDepth);
+
+        // Queue priority survives: the same sweep fills the same orders in the same order
+        std::vector<std::uint64_t> originalFills, restoredFills;
+        original.setTradeCallback([&](const Trade &trade)
+                                  { originalFills.push_back(trade.buyOrderId); });
+        restored.setTradeCallback([&](const Trade &trade)
+                                  { restoredFills.push_back(trade.buyOrderId); });
+        original.addOrder(900, OrderSide::SELL, 99.60, 300);
+        restored.addOrder(900, OrderSide::SELL, 99.60, 300);
+        ASSERT_TRUE(!originalFills.empty());
+        ASSERT_TRUE(originalFills == restoredFills);
+    }
+
+    // A snapshot is only valid for a book on the same tick grid
+    OrderBook coarse(0.05);
+    bool threw = false;
+    try
+    {
+        coarse.loadSnapshot(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+
+    // A snapshot written on a host of the other byte order is rejected
+    auto setByteOrder = [&path](std::uint32_t byteOrder)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        SnapshotHeader header{};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        header.byteOrder = byteOrder;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    };
+    setByteOrder(0x04030201);
+    threw = false;
+    try
+    {
+        OrderBook foreign;
+        foreign.loadSnapshot(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    setByteOrder(kSnapshotByteOrder);
+
+    // Record counts whose byte size wraps to the real file size are rejected
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        SnapshotHeader header{};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+        // 2^58 more records of 64 bytes add exactly 2^64 bytes, so the
+        // unchecked size product wraps back to the real file size
+        header.bidOrders += std::uint64_t{1} << 58;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    }
+    threw = false;
+    try
+    {
+        OrderBook wrapped;
+        wrapped.loadSnapshot(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+
+    // A ladder book rejects a snapshot wider than its window cap, leaving it empty
+    OrderBook wide(1.0);
+    wide.addOrder(1, OrderSide::BUY, 100, 10);
+    wide.addOrder(2, OrderSide::BUY, 1e7, 10);
+    wide.saveSnapshot(path);
+    BookOptions capped;
+    capped.tickSize = 1.0;
+    capped.levelStorage = LevelStorage::Ladder;
+    capped.maxLadderTicks = 1024;
+    OrderBook narrow(capped);
+    narrow.addOrder(3, OrderSide::SELL, 2e7, 10);
+    threw = false;
+    try
+    {
+        narrow.loadSnapshot(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    ASSERT_EQ(narrow.getOrderCount(), 0u);
+
+    std::remove(path.c_str());
+}
+
+void testBulkLoadRestingOrders()
+{
+    std::vector<OrderRequest> batch;
+    for (std::uint64_t id = 1; id <= 1000; ++id)
+    {
+        OrderRequest request;
+        request.orderId = id;
+        request.side = (id % 3 == 0) ? OrderSide::SELL : OrderSide::BUY;
+        request.price = request.side == OrderSide::BUY ? 99.99 - static_cast<double>(id % 50) * 0.01
+                                                       : 100.01 + static_cast<double>(id % 40) * 0.01;
+        request.quantity = 1 + id % 17;
+        batch.push_back(request);
+    }
+
+    for (LevelStorage storage : {LevelStorage::Map, LevelStorage::Ladder})
+    {
+        BookOptions options;
+        options.levelStorage = storage;
+        OrderBook loaded(options);
+        OrderBook added(options);
+        std::size_t topUpdates = 0;
+        loaded.setTopOfBookCallback([&](const TopOfBook &)
+                                    { ++topUpdates; });
+
+        loaded.loadRestingOrders(batch.data(), batch.size());
+        for (const OrderRequest &request : batch)
+        {
+            added.addOrder(request.orderId, request.side, request.price, request.quantity);
+        }
+
+        ASSERT_EQ(topUpdates, 1);
+        ASSERT_EQ(loaded.getOrderCount(), 1000);
+        ASSERT_TRUE(loaded.getTopOfBook() == added.getTopOfBook());
+        ASSERT_EQ(loaded.getDepthAtPrice(99.75, OrderSide::BUY), added.getDepthAtPrice(99.75, OrderSide::BUY));
+
+        // Input order is time priority: a sweep fills in the same sequence
+        std::vector<std::uint64_t> loadedFills, addedFills;
+        loaded.setTradeCallback([&](const Trade &trade)
+                                { loadedFills.push_back(trade.buyOrderId); });
+        added.setTradeCallback([&](const Trade &trade)
+                               { addedFills.push_back(trade.buyOrderId); });
+        loaded.addOrder(5000, OrderSide::SELL, 99.80, 2000);
+        added.addOrder(5000, OrderSide::SELL, 99.80, 2000);
+        ASSERT_TRUE(!loadedFills.empty());
+        ASSERT_TRUE(loadedFills == addedFills);
+    }
+
+    // Rejected batches leave the book as it was
+    OrderBook book;
+    book.addOrder(1, OrderSide::BUY, 99.00, 10);
+    book.addOrder(2, OrderSide::SELL, 101.00, 10);
+
+    OrderRequest crossing[2];
+    crossing[0] = {RequestType::Add, OrderSide::BUY, 10, 100.00, 5};
+    crossing[1] = {RequestType::Add, OrderSide::SELL, 11, 100.00, 5};
+    bool threw = false;
+    try
+    {
+        book.loadRestingOrders(crossing, 2);
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+
+    OrderRequest duplicate[3];
+    duplicate[0] = {RequestType::Add, OrderSide::BUY, 10, 98.00, 5};
+    duplicate[1] = {RequestType::Add, OrderSide::SELL, 11, 102.00, 5};
+    duplicate[2] = {RequestType::Add, OrderSide::BUY, 1, 99.50, 5};
+    threw = false;
+    try
+    {
+        book.loadRestingOrders(duplicate, 3);
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+    ASSERT_EQ(book.getOrderCount(), 2);
+    ASSERT_EQ(book.getDepthAtPrice(98.00, OrderSide::BUY), 0);
+    ASSERT_EQ(book.getBestBid().value(), 99.00);
+
+    // Loading into a live book interleaves with its levels
+    OrderRequest extra[2];
+    extra[0] = {RequestType::Add, OrderSide::BUY, 20, 99.50, 5};
+    extra[1] = {RequestType::Add, OrderSide::BUY, 21, 98.50, 5};
+    book.loadRestingOrders(extra, 2);
+    ASSERT_EQ(book.getBestBid().value(), 99.50);
+    ASSERT_EQ(book.getOrderCount(), 4);
+}
+
+void testCommandRings()
+{
+    // SPSC: FIFO across threads, including wrap-around of a small ring
+    SpscRing<std::uint64_t> spsc(8);
+    const std::uint64_t total = 100000;
+    std::thread producer([&]
+                         {
+                             for (std::uint64_t i = 1; i <= total; ++i)
+                             {
+                                 while (!spsc.tryPush(i))
+                                 {
+                                     std::this_thread::yield();
+                                 }
+                             } });
+    bool inOrder = true;
+    std::uint64_t expected = 1;
+    std::uint64_t batch[16];
+    while (expected <= total)
+    {
+        std::size_t count = spsc.popBatch(batch, 16);
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            inOrder = inOrder && batch[i] == expected++;
+        }
+    }
+    producer.join();
+    ASSERT_TRUE(inOrder);
+    ASSERT_TRUE(spsc.empty());
+
+    // MPSC: nothing lost or duplicated, and each producer's items stay in order
+    struct Item
+    {
+        std::uint32_t producer;
+        std::uint32_t value;
+    };
+    MpscRing<Item> mpsc(64);
+    const std::uint32_t perProducer = 50000;
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < 4; ++p)
+    {
+        producers.emplace_back([&mpsc, p, perProducer]
+                               {
+                                   for (std::uint32_t v = 0; v < perProducer; ++v)
+                                   {
+                                       while (!mpsc.tryPush(Item{p, v}))
+                                       {
+                                           std::this_thread::yield();
+                                       }
+                                   } });
+    }
+    std::vector<std::uint32_t> next(4, 0);
+    std::size_t received = 0;
+    inOrder = true;
+    Item item;
+    while (received < 4 * perProducer)
+    {
+        if (mpsc.tryPop(item))
+        {
+            inOrder = inOrder && item.value == next[item.producer]++;
+            ++received;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread &thread : producers)
+    {
+        thread.join();
+    }
+    ASSERT_TRUE(inOrder);
+    ASSERT_TRUE(mpsc.empty());
+}
+
+void testEngineThread()
+{
+    // Busy-spin is left to the benchmark: on a machine with fewer cores than
+    // spinning threads it only makes progress at scheduler timeslices
+    for (WaitStrategy wait : {WaitStrategy::Yield, WaitStrategy::Block})
+    {
+        OrderBook book;
+        std::size_t trades = 0;
+        book.setTradeCallback([&](const Trade &)
+                              { ++trades; });
+
+        EngineThreadOptions options;
+        options.wait = wait;
+        options.ingressCapacity = 32; // Exercise backpressure
+        options.egressCapacity = 32;
+        EngineThread<OrderBook, MpscRing<EngineCommand>> engine(book, options);
+        engine.start();
+
+        const std::uint64_t commands = 2000;
+        std::vector<EngineAck> acks;
+        std::thread ackReader([&]
+                              {
+                                  EngineAck ack;
+                                  while (acks.size() < commands)
+                                  {
+                                      if (engine.pollAck(ack))
+                                      {
+                                          acks.push_back(ack);
+                                      }
+                                      else
+                                      {
+                                          std::this_thread::yield();
+                                      }
+                                  } });
+
+        for (std::uint64_t tag = 1; tag <= commands; ++tag)
+        {
+            EngineCommand command;
+            command.clientTag = tag;
+            command.request.orderId = (tag + 1) / 2; // Every id is submitted twice
+            command.request.side = command.request.orderId % 2 ? OrderSide::BUY : OrderSide::SELL;
+            command.request.price = 100.00;
+            command.request.quantity = 10;
+            while (!engine.trySubmit(command))
+            {
+                std::this_thread::yield();
+            }
+        }
+        ackReader.join();
+        engine.stop();
+
+        // Same outcome as applying the commands directly, one by one
+        OrderBook reference;
+        std::size_t referenceTrades = 0;
+        reference.setTradeCallback([&](const Trade &)
+                                   { ++referenceTrades; });
+        bool ordered = true;
+        bool sameResults = true;
+        for (std::uint64_t tag = 1; tag <= commands; ++tag)
+        {
+            std::uint64_t id = (tag + 1) / 2;
+            OrderResult result = reference.addOrder(id, id % 2 ? OrderSide::BUY : OrderSide::SELL, 100.00, 10);
+            ordered = ordered && acks[tag - 1].clientTag == tag && acks[tag - 1].orderId == id;
+            sameResults = sameResults && acks[tag - 1].result == result;
+        }
+        ASSERT_TRUE(ordered);
+        ASSERT_TRUE(sameResults);
+        ASSERT_EQ(trades, referenceTrades);
+        ASSERT_EQ(book.getOrderCount(), reference.getOrderCount());
+    }
+
+    // With a journal, an ack is only released once its record is durable
+    const std::string path = (std::filesystem::temp_directory_path() / "orderbook_engine_journal_test.bin").string();
+    std::remove(path.c_str());
+    {
+        JournalOptions journalOptions;
+        journalOptions.path = path;
+        JournalWriter journal(journalOptions);
+        BookOptions bookOptions;
+        bookOptions.journal = &journal;
+        OrderBook book(bookOptions);
+
+        EngineThreadOptions options;
+        options.wait = WaitStrategy::Block;
+        options.ingressCapacity = 16; // Held acks fill their ring and wait on the journal
+        EngineThread<OrderBook> engine(book, options);
+        engine.start();
+
+        const std::uint64_t commands = 200;
+        for (std::uint64_t tag = 1; tag <= commands; ++tag)
+        {
+            EngineCommand command;
+            command.clientTag = tag;
+            command.request.orderId = tag;
+            command.request.side = tag % 2 ? OrderSide::BUY : OrderSide::SELL;
+            command.request.price = tag % 2 ? 99.00 : 101.00;
+            command.request.quantity = tag % 10 == 0 ? 0 : 10; // Rejected: not journaled
+            engine.submit(command);
+        }
+
+        std::uint64_t journaled = 0;
+        bool durableBeforeAck = true;
+        bool inOrder = true;
+        EngineAck ack;
+        for (std::uint64_t received = 0; received < commands;)
+        {
+            if (!engine.pollAck(ack))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            ++received;
+            inOrder = inOrder && ack.clientTag == received;
+            journaled += ack.result == OrderResult::Accepted;
+            durableBeforeAck = durableBeforeAck && journal.durableSequence() >= journaled;
+        }
+        engine.stop();
+        ASSERT_TRUE(durableBeforeAck);
+        ASSERT_TRUE(inOrder);
+        ASSERT_EQ(journaled, 180u);
+        ASSERT_EQ(book.journalSequence(), journaled);
+    }
+    std::remove(path.c_str());
+}
+
+void testMatchingEngine()
+{
+    MatchingEngineOptions options;
+    options.shards = 2;
+    options.wait = WaitStrategy::Block;
+    options.ingressCapacity = 64; // Exercise backpressure
+    options.egressCapacity = 64;
+    MatchingEngine engine(options);
+
+    const std::size_t symbols = 4;
+    std::vector<std::size_t> trades(symbols, 0);
+    for (std::size_t s = 0; s < symbols; ++s)
+    {
+        SymbolId id = engine.addSymbol("SYM" + std::to_string(s));
+        engine.book(id).setTradeCallback([&trades, s](const Trade &)
+                                         { ++trades[s]; });
+    }
+    bool duplicateRejected = false;
+    try
+    {
+        engine.addSymbol("SYM0");
+    }
+    catch (const std::invalid_argument &)
+    {
+        duplicateRejected = true;
+    }
+    ASSERT_TRUE(duplicateRejected);
+    SymbolId found = 0;
+    ASSERT_TRUE(engine.findSymbol("SYM3", found) && found == 3);
+    ASSERT_EQ(engine.shardOf(1), 1u);
+
+    engine.start();
+
+    const std::uint64_t commands = 4000;
+    std::vector<SymbolAck> acks;
+    std::thread ackReader([&]
+                          {
+                              SymbolAck batch[32];
+                              while (acks.size() < commands)
+                              {
+                                  std::size_t count = engine.pollAcks(batch, 32);
+                                  acks.insert(acks.end(), batch, batch + count);
+                                  if (count == 0)
+                                  {
+                                      std::this_thread::yield();
+                                  }
+                              } });
+
+    // Crossing adds and cancels, with symbols moved between shards mid-stream
+    std::mt19937 rng(7);
+    std::vector<std::pair<SymbolId, OrderRequest>> sent;
+    std::size_t moves = 0;
+    for (std::uint64_t tag = 1; tag <= commands; ++tag)
+    {
+        EngineCommand command;
+        command.clientTag = tag;
+        SymbolId symbol = static_cast<SymbolId>(rng() % symbols);
+        command.request.type = rng() % 4 == 0 ? RequestType::Cancel : RequestType::Add;
+        command.request.orderId = 1 + rng() % 500;
+        command.request.side = rng() % 2 ? OrderSide::BUY : OrderSide::SELL;
+        command.request.price = 99.95 + 0.01 * (rng() % 10);
+        command.request.quantity = 1 + rng() % 20;
+        engine.submit(symbol, command);
+        sent.emplace_back(symbol, command.request);
+
+        if (tag % 500 == 0)
+        {
+            SymbolId moving = static_cast<SymbolId>((tag / 500) % symbols);
+            engine.moveSymbol(moving, (engine.shardOf(moving) + 1) % engine.shardCount());
+            ++moves;
+        }
+    }
+    ackReader.join();
+    moves += engine.rebalance();
+    engine.stop();
+    ASSERT_TRUE(moves >= 8);
+    ASSERT_EQ(engine.processedCommands(), commands);
+
+    // Same outcome per symbol as applying its commands directly
+    std::vector<OrderBook> reference(symbols);
+    std::vector<std::size_t> referenceTrades(symbols, 0);
+    for (std::size_t s = 0; s < symbols; ++s)
+    {
+        reference[s].setTradeCallback([&referenceTrades, s](const Trade &)
+                                      { ++referenceTrades[s]; });
+    }
+    std::vector<OrderResult> expected;
+    for (const auto &entry : sent)
+    {
+        OrderResult result;
+        reference[entry.first].submitBatch(&entry.second, 1, &result);
+        expected.push_back(result);
+    }
+
+    bool sameResults = acks.size() == commands;
+    std::set<std::uint64_t> acked;
+    for (const SymbolAck &ack : acks)
+    {
+        const std::uint64_t tag = ack.ack.clientTag;
+        sameResults = sameResults && sent[tag - 1].first == ack.symbol && expected[tag - 1] == ack.ack.result;
+        acked.insert(tag);
+    }
+    ASSERT_TRUE(sameResults);
+    ASSERT_EQ(acked.size(), commands);
+    for (std::size_t s = 0; s < symbols; ++s)
+    {
+        ASSERT_EQ(trades[s], referenceTrades[s]);
+        ASSERT_EQ(engine.book(static_cast<SymbolId>(s)).getOrderCount(), reference[s].getOrderCount());
+    }
+
+    // Hand-overs in both directions while every ingress ring is full: a
+    // shard releasing a symbol must never wait on the other shard's ring
+    MatchingEngineOptions tightOptions;
+    tightOptions.shards = 2;
+    tightOptions.wait = WaitStrategy::Yield;
+    tightOptions.ingressCapacity = 4;
+    tightOptions.acks = false;
+    MatchingEngine tight(tightOptions);
+    for (std::size_t s = 0; s < symbols; ++s)
+    {
+        tight.addSymbol("SYM" + std::to_string(s));
+    }
+    tight.start();
+
+    const std::uint64_t perProducer = 2000;
+    std::vector<std::thread> producers;
+    for (std::uint64_t p = 0; p < 2; ++p)
+    {
+        producers.emplace_back([&tight, p, perProducer]
+                               {
+                                   for (std::uint64_t i = 0; i < perProducer; ++i)
+                                   {
+                                       EngineCommand command;
+                                       command.request.orderId = p * perProducer + i + 1;
+                                       command.request.side = i % 2 ? OrderSide::BUY : OrderSide::SELL;
+                                       command.request.price = 100.00;
+                                       command.request.quantity = 1;
+                                       tight.submit(static_cast<SymbolId>(i % 4), command);
+                                   } });
+    }
+    for (std::size_t round = 0; round < 50; ++round)
+    {
+        tight.moveSymbol(0, tight.shardOf(0) ^ 1);
+        tight.moveSymbol(1, tight.shardOf(1) ^ 1);
+    }
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    tight.stop();
+    ASSERT_EQ(tight.processedCommands(), 2 * perProducer);
+
+    // Journaled symbols sharing a shard: each ack waits for its own journal
+    const std::string paths[2] = {
+        (std::filesystem::temp_directory_path() / "orderbook_engine_journal_a.bin").string(),
+        (std::filesystem::temp_directory_path() / "orderbook_engine_journal_b.bin").string()};
+    for (const std::string &path : paths)
+    {
+        std::remove(path.c_str());
+    }
+    {
+        std::vector<std::unique_ptr<JournalWriter>> journals;
+        MatchingEngineOptions journaledOptions;
+        journaledOptions.wait = WaitStrategy::Block;
+        MatchingEngine journaled(journaledOptions);
+        for (std::size_t s = 0; s < 2; ++s)
+        {
+            JournalOptions journalOptions;
+            journalOptions.path = paths[s];
+            journals.push_back(std::make_unique<JournalWriter>(journalOptions));
+            BookOptions bookOptions;
+            bookOptions.journal = journals.back().get();
+            journaled.addSymbol("J" + std::to_string(s), bookOptions);
+        }
+        bool sharedRejected = false;
+        try
+        {
+            BookOptions shared;
+            shared.journal = journals[0].get();
+            journaled.addSymbol("J2", shared);
+        }
+        catch (const std::invalid_argument &)
+        {
+            sharedRejected = true;
+        }
+        ASSERT_TRUE(sharedRejected);
+        ASSERT_EQ(journaled.symbolCount(), 2u);
+        journaled.start();
+
+        const std::uint64_t journaledCommands = 400;
+        for (std::uint64_t tag = 1; tag <= journaledCommands; ++tag)
+        {
+            EngineCommand command;
+            command.clientTag = tag;
+            command.request.orderId = tag;
+            command.request.side = OrderSide::BUY;
+            command.request.price = 99.00;
+            command.request.quantity = 10;
+            journaled.submit(static_cast<SymbolId>(tag % 2), command);
+        }
+
+        std::uint64_t accepted[2] = {0, 0};
+        bool durableBeforeAck = true;
+        SymbolAck ack;
+        for (std::uint64_t received = 0; received < journaledCommands;)
+        {
+            if (journaled.pollAcks(&ack, 1) == 0)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            ++received;
+            accepted[ack.symbol] += ack.ack.result == OrderResult::Accepted;
+            durableBeforeAck = durableBeforeAck && journals[ack.symbol]->durableSequence() >= accepted[ack.symbol];
+        }
+        journaled.stop();
+        ASSERT_TRUE(durableBeforeAck);
+        ASSERT_EQ(accepted[0] + accepted[1], journaledCommands);
+    }
+    for (const std::string &path : paths)
+    {
+        std::remove(path.c_str());
+    }
+}
+
+void testDepthFeed()
+{
+    DepthFeed feed;
+    BookOptions options;
+    options.depthFeed = &feed;
+    OrderBook book(options);
+
+    for (std::uint64_t i = 0; i < 12; ++i)
+    {
+        book.addOrder(i + 1, OrderSide::BUY, 99.00 - 0.01 * i, 10);
+    }
+    book.addOrder(100, OrderSide::SELL, 101.00, 5);
+    book.addOrder(101, OrderSide::SELL, 101.00, 7);
+
+    DepthSnapshot depth = feed.read();
+    ASSERT_EQ(depth.bidLevels, DepthSnapshot::kLevels); // Capped at the top N
+    ASSERT_EQ(depth.askLevels, 1u);
+    ASSERT_EQ(depth.bids[0].price, book.toTicks(99.00));
+    ASSERT_EQ(depth.bids[9].price, book.toTicks(98.91));
+    ASSERT_EQ(depth.asks[0].quantity, 12u);
+    ASSERT_EQ(depth.asks[0].orders, 2u);
+    ASSERT_EQ(feed.version(), 14u); // One publish per message
+
+    book.cancelOrder(1);
+    ASSERT_EQ(feed.read().bids[0].price, book.toTicks(98.99));
+
+    // A cancel stamps its depth update (and journal record) with its own time
+    DepthFeed replayFeed;
+    BookOptions replayOptions;
+    replayOptions.depthFeed = &replayFeed;
+    replayOptions.clock = ClockSource::Replay;
+    OrderBook replayed(replayOptions);
+    replayed.clock().set(1000);
+    replayed.addOrder(1, OrderSide::BUY, 99.00, 10);
+    replayed.clock().set(2000);
+    ASSERT_TRUE(replayed.cancelOrder(1));
+    ASSERT_EQ(replayFeed.read().timestamp, 2000u);
+
+    // Readers on other threads only ever see states the book passed through
+    DepthFeed churnFeed;
+    BookOptions churnOptions;
+    churnOptions.depthFeed = &churnFeed;
+    OrderBook churn(churnOptions);
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+    std::atomic<std::uint64_t> reads{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r)
+    {
+        readers.emplace_back([&]
+                             {
+                                 while (!done.load(std::memory_order_acquire))
+                                 {
+                                     DepthSnapshot view;
+                                     if (!churnFeed.tryRead(view))
+                                     {
+                                         std::this_thread::yield();
+                                         continue;
+                                     }
+                                     bool ok = view.bidLevels <= DepthSnapshot::kLevels && view.askLevels <= DepthSnapshot::kLevels;
+                                     for (std::uint32_t i = 0; ok && i < view.bidLevels; ++i)
+                                     {
+                                         ok = view.bids[i].quantity == 10 * view.bids[i].orders &&
+                                              (i == 0 || view.bids[i].price < view.bids[i - 1].price);
+                                     }
+                                     for (std::uint32_t i = 0; ok && i < view.askLevels; ++i)
+                                     {
+                                         ok = view.asks[i].quantity == 10 * view.asks[i].orders &&
+                                              (i == 0 || view.asks[i].price > view.asks[i - 1].price);
+                                     }
+                                     if (!ok)
+                                     {
+                                         consistent.store(false);
+                                     }
+                                     reads.fetch_add(1, std::memory_order_relaxed);
+                                     std::this_thread::yield();
+                                 } });
+    }
+
+    std::mt19937 rng(11);
+    for (std::uint64_t id = 1; id <= 20000; ++id)
+    {
+        OrderSide side = rng() % 2 ? OrderSide::BUY : OrderSide::SELL;
+        double price = side == OrderSide::BUY ? 99.50 - 0.01 * (rng() % 40) : 100.50 + 0.01 * (rng() % 40);
+        churn.addOrder(id, side, price, 10);
+        if (id > 50)
+        {
+            churn.cancelOrder(id - 50);
+        }
+        if (id % 100 == 0)
+        {
+            std::this_thread::yield(); // Let readers run on a single core
+        }
+    }
+    while (reads.load(std::memory_order_relaxed) < 100)
+    {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+    ASSERT_TRUE(consistent.load());
+}
+
+void testTimeInForce()
+{
+    OrderBook book;
+    std::vector<Trade> trades;
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+
+    book.addOrder(1, OrderSide::SELL, 100.00, 10);
+    book.addOrder(2, OrderSide::SELL, 100.01, 10);
+    book.addOrder(3, OrderSide::SELL, 100.05, 10);
+
+    // IOC takes what crosses and drops the rest without resting it
+    ASSERT_TRUE(book.addOrder(10, OrderSide::BUY, 100.01, 25, TimeInForce::ImmediateOrCancel) == OrderResult::Accepted);
+    ASSERT_EQ(trades.size(), 2u);
+    ASSERT_EQ(book.getOrderCount(), 1u);
+    ASSERT_FALSE(book.getBestBid().has_value());
+    ASSERT_TRUE(book.cancelOrder(10) == false);
+
+    // FOK is killed unless the whole quantity is available within its limit
+    ASSERT_TRUE(book.addOrder(11, OrderSide::BUY, 100.05, 11, TimeInForce::FillOrKill) == OrderResult::Killed);
+    ASSERT_EQ(trades.size(), 2u);
+    ASSERT_EQ(book.getDepthAtPrice(100.05, OrderSide::SELL), 10u);
+    ASSERT_TRUE(book.addOrder(12, OrderSide::BUY, 100.05, 10, TimeInForce::FillOrKill) == OrderResult::Accepted);
+    ASSERT_EQ(trades.size(), 3u);
+    ASSERT_EQ(book.getOrderCount(), 0u);
+
+    // Market orders sweep at the resting prices and never rest
+    book.addOrder(20, OrderSide::BUY, 99.00, 5);
+    book.addOrder(21, OrderSide::BUY, 98.00, 5);
+    ASSERT_TRUE(book.addMarketOrder(22, OrderSide::SELL, 8) == OrderResult::Accepted);
+    ASSERT_EQ(trades.size(), 5u);
+    ASSERT_EQ(trades[3].price, 99.00);
+    ASSERT_EQ(trades[4].price, 98.00);
+    ASSERT_EQ(book.getDepthAtPrice(98.00, OrderSide::BUY), 2u);
+    ASSERT_TRUE(book.addMarketOrder(23, OrderSide::SELL, 5, TimeInForce::FillOrKill) == OrderResult::Killed);
+    ASSERT_TRUE(book.addMarketOrder(24, OrderSide::SELL, 5) == OrderResult::Accepted);
+    ASSERT_EQ(book.getOrderCount(), 0u);
+    ASSERT_TRUE(book.addMarketOrder(25, OrderSide::BUY, 5) == OrderResult::Accepted); // Nothing to take
+    ASSERT_EQ(book.getOrderCount(), 0u);
+
+    // Ids must still be unique against resting orders; batches carry the type
+    book.addOrder(30, OrderSide::SELL, 101.00, 4);
+    ASSERT_TRUE(book.addOrder(30, OrderSide::BUY, 101.00, 1, TimeInForce::ImmediateOrCancel) == OrderResult::DuplicateId);
+    OrderRequest requests[2];
+    requests[0] = OrderRequest{RequestType::Add, OrderSide::BUY, 31, 101.00, 10, 0, OrderType::Limit, TimeInForce::ImmediateOrCancel};
+    requests[1] = OrderRequest{RequestType::Add, OrderSide::BUY, 32, 0.0, 1, 0, OrderType::Market, TimeInForce::FillOrKill};
+    OrderResult results[2];
+    book.submitBatch(requests, 2, results);
+    ASSERT_TRUE(results[0] == OrderResult::Accepted);
+    ASSERT_TRUE(results[1] == OrderResult::Killed);
+    ASSERT_EQ(book.getOrderCount(), 0u);
+}
+
+struct CancelCountingListener : BookListener
+{
+    std::size_t cancels = 0;
+
+    void onCancel(const Order &) { ++cancels; }
+};
+
+void testMatchBeforeInsert()
+{
+    BasicOrderBook<CancelCountingListener> book{BookOptions{}};
+    book.addOrder(1, OrderSide::SELL, 101.00, 10);
+    book.addOrder(2, OrderSide::SELL, 101.50, 10);
+
+    // A taker filled on arrival never takes a pool slot or an index entry
+    ASSERT_TRUE(book.addOrder(3, OrderSide::BUY, 101.50, 15) == OrderResult::Accepted);
+    ASSERT_EQ(book.getOrderCount(), 1u);
+    ASSERT_EQ(book.getPooledOrderCount(), 1u);
+    ASSERT_FALSE(book.cancelOrder(3));
+    ASSERT_TRUE(book.addOrder(3, OrderSide::SELL, 102.00, 5) == OrderResult::Accepted); // Id is free again
+    ASSERT_EQ(book.getPooledOrderCount(), 2u);
+
+    // Only a remainder rests
+    ASSERT_TRUE(book.addOrder(4, OrderSide::BUY, 101.50, 8) == OrderResult::Accepted);
+    ASSERT_EQ(book.getDepthAtPrice(101.50, OrderSide::BUY), 3u);
+    ASSERT_EQ(book.getPooledOrderCount(), book.getOrderCount());
+
+    // A zero-quantity modify is rejected rather than dropping the order silently
+    ASSERT_FALSE(book.modifyOrder(4, 101.50, 0));
+    ASSERT_EQ(book.getDepthAtPrice(101.50, OrderSide::BUY), 3u);
+    OrderRequest zero{RequestType::Modify, OrderSide::BUY, 4, 101.50, 0};
+    OrderResult result;
+    book.submitBatch(&zero, 1, &result);
+    ASSERT_TRUE(result == OrderResult::InvalidQuantity);
+    ASSERT_EQ(book.listener().cancels, 0u);
+    ASSERT_TRUE(book.cancelOrder(4));
+    ASSERT_EQ(book.listener().cancels, 1u);
+    ASSERT_EQ(book.getPooledOrderCount(), book.getOrderCount());
+}
+
+void testModifyKeepsPriorityOnSizeDown()
+{
+    OrderBook book;
+    std::vector<Trade> trades;
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+
+    book.addOrder(1, OrderSide::SELL, 101.00, 10);
+    book.addOrder(2, OrderSide::SELL, 101.00, 10);
+    book.addOrder(3, OrderSide::SELL, 101.00, 10);
+
+    // Size-down in place: same queue position, aggregates follow
+    ASSERT_TRUE(book.modifyOrder(1, 101.00, 4));
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::SELL), 24u);
+    ASSERT_EQ(book.getOrderCountAtPrice(101.00, OrderSide::SELL), 3u);
+    ASSERT_EQ(book.getTopOfBook().askQuantity, 24u);
+
+    // Size-up goes to the back of the queue
+    ASSERT_TRUE(book.modifyOrder(2, 101.00, 12));
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::SELL), 26u);
+
+    book.addOrder(10, OrderSide::BUY, 101.00, 26);
+    ASSERT_EQ(trades.size(), 3u);
+    ASSERT_EQ(trades[0].sellOrderId, 1u);
+    ASSERT_EQ(trades[0].quantity, 4u);
+    ASSERT_EQ(trades[1].sellOrderId, 3u);
+    ASSERT_EQ(trades[2].sellOrderId, 2u);
+    ASSERT_EQ(book.getOrderCount(), 0u);
+}
+
+void testIcebergOrders()
+{
+    OrderBook book;
+    std::vector<Trade> trades;
+    book.setTradeCallback([&](const Trade &trade)
+                          { trades.push_back(trade); });
+
+    // Only the peak is displayed
+    ASSERT_TRUE(book.addIcebergOrder(1, OrderSide::SELL, 100.00, 25, 10) == OrderResult::Accepted);
+    book.addOrder(2, OrderSide::SELL, 100.00, 5);
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::SELL), 15u);
+    ASSERT_EQ(book.getTopOfBook().askQuantity, 15u);
+    ASSERT_TRUE(book.addIcebergOrder(3, OrderSide::SELL, 100.00, 25, 0) == OrderResult::InvalidQuantity);
+
+    // A filled peak is replenished behind the rest of the queue
+    book.addOrder(10, OrderSide::BUY, 100.00, 12);
+    ASSERT_EQ(trades.size(), 2u);
+    ASSERT_EQ(trades[0].sellOrderId, 1u);
+    ASSERT_EQ(trades[0].quantity, 10u);
+    ASSERT_EQ(trades[1].sellOrderId, 2u);
+    ASSERT_EQ(trades[1].quantity, 2u);
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::SELL), 13u);
+    ASSERT_EQ(book.getOrderCountAtPrice(100.00, OrderSide::SELL), 2u);
+
+    // One sweep takes the remaining peaks and the reserve without re-entry
+    book.addOrder(11, OrderSide::BUY, 100.00, 20);
+    ASSERT_EQ(trades.size(), 5u);
+    ASSERT_EQ(trades[2].sellOrderId, 2u);
+    ASSERT_EQ(trades[3].sellOrderId, 1u);
+    ASSERT_EQ(trades[3].quantity, 10u);
+    ASSERT_EQ(trades[4].sellOrderId, 1u);
+    ASSERT_EQ(trades[4].quantity, 5u);
+    ASSERT_EQ(book.getOrderCount(), 1u);
+    ASSERT_EQ(book.getDepthAtPrice(100.00, OrderSide::BUY), 2u);
+    book.cancelOrder(11);
+
+    // An incoming iceberg takes with its full size, then rests a peak
+    book.addOrder(20, OrderSide::SELL, 101.00, 30);
+    ASSERT_TRUE(book.addIcebergOrder(21, OrderSide::BUY, 101.00, 50, 5) == OrderResult::Accepted);
+    ASSERT_EQ(trades.back().quantity, 30u);
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::BUY), 5u);
+
+    // A size-down comes out of the reserve first, keeping priority
+    book.addOrder(22, OrderSide::BUY, 101.00, 1);
+    ASSERT_TRUE(book.modifyOrder(21, 101.00, 12));
+    ASSERT_EQ(book.getDepthAtPrice(101.00, OrderSide::BUY), 6u);
+
+    // Snapshots keep the reserve
+    const std::string path = (std::filesystem::temp_directory_path() / "orderbook_iceberg_test.snap").string();
+    book.saveSnapshot(path);
+    OrderBook restored;
+    std::vector<Trade> restoredTrades;
+    restored.setTradeCallback([&](const Trade &trade)
+                              { restoredTrades.push_back(trade); });
+    restored.loadSnapshot(path);
+    std::remove(path.c_str());
+    ASSERT_EQ(restored.getDepthAtPrice(101.00, OrderSide::BUY), 6u);
+    restored.addOrder(30, OrderSide::SELL, 101.00, 13);
+    ASSERT_EQ(restoredTrades.size(), 4u); // Peak 5, the plain order, peak 5, last 2
+    ASSERT_EQ(restoredTrades[1].buyOrderId, 22u);
+    ASSERT_EQ(restored.getOrderCount(), 0u);
+}
+
 int main()
 {
     std::cout << "Running OrderBook Tests..." << std::endl;
@@ -258,6 +2124,34 @@ int main()
     testMarketCrossingOrders();
     testMultiLevelMatching();
     testPriceTimePriority();
+    testTickPriceLevels();
+    testOffGridPricesRejected();
+    testCancelPreservesQueueOrder();
+    testSingleLevelInsertStress();
+    testOrderPoolRecycling();
+    testLadderBackend();
+    testLadderWindowCap();
+    testLadderMatchesMapBackend();
+    testLevelBitmapSearch();
+    testOrderIdIndex();
+    testLevelAggregates();
+    testCompileTimeListener();
+    testTopOfBookNotifications();
+    testBatchSubmission();
+    testEmplaceOrderEntry();
+    testEngineClock();
+    testReplayClock();
+    testJournalRecovery();
+    testSnapshotRoundTrip();
+    testBulkLoadRestingOrders();
+    testCommandRings();
+    testEngineThread();
+    testMatchingEngine();
+    testDepthFeed();
+    testTimeInForce();
+    testMatchBeforeInsert();
+    testModifyKeepsPriorityOnSizeDown();
+    testIcebergOrders();
 
     SimpleTest::printSummary();
 